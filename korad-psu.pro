@@ -13,6 +13,11 @@ TEMPLATE = app
 
 QT += serialport
 QT += printsupport
+QT += concurrent
+QT += network
+
+# over-aligned new: per-device state is cache line aligned
+CONFIG += c++17
 
 # The following define makes your compiler emit warnings if you use
 # any feature of Qt which has been marked as deprecated (the exact warnings
@@ -20,6 +25,10 @@ QT += printsupport
 # deprecated API in order to know how to port your code away from it.
 DEFINES += QT_DEPRECATED_WARNINGS
 #DEFINES += QCUSTOMPLOT_USE_OPENGL
+DEFINES += QCUSTOMPLOT_USE_TRACE
+
+# Log calls below the minimum level are compiled out (see src/Log.h); release builds keep warnings & errors only
+CONFIG(release, debug|release): DEFINES += LOG_MIN_LEVEL=LOG_LEVEL_WARNING
 
 # You can also make your code fail to compile if you use deprecated APIs.
 # In order to do so, uncomment the following line.
@@ -32,13 +41,54 @@ SOURCES += \
 	src/mainwindow.cpp \
 	src/ProtocolClass.cpp \
 	src/SerialPortClass.cpp \
+	src/ReadoutWidget.cpp \
+	src/Log.cpp \
+	src/WireTraceClass.cpp \
+	src/StatisticsClass.cpp \
+	src/UnixSignalClass.cpp \
+	src/MetricsServerClass.cpp \
+	src/Trace.cpp \
+	src/WatchdogClass.cpp \
+	src/HotplugClass.cpp \
+	src/NativeSerialPortClass.cpp \
+	src/TransportClass.cpp \
+	src/SerialTransportClass.cpp \
+	src/TcpTransportClass.cpp \
+	src/DeviceClass.cpp \
+	src/DeviceManagerClass.cpp \
+	src/SyncCaptureClass.cpp \
+	src/DashboardWidget.cpp \
+	src/ModelClass.cpp \
+	src/SeriesClass.cpp \
+	src/SeriesGraphClass.cpp \
+	src/StatusClass.cpp \
 	src/qcustomplot.cpp
 
 HEADERS += \
 	src/mainwindow.h \
 	src/ProtocolClass.h \
 	src/SerialPortClass.h \
+	src/ReadoutWidget.h \
 	src/Log.h \
+	src/WireTraceClass.h \
+	src/StatisticsClass.h \
+	src/UnixSignalClass.h \
+	src/MetricsServerClass.h \
+	src/Trace.h \
+	src/WatchdogClass.h \
+	src/HotplugClass.h \
+	src/NativeSerialPortClass.h \
+	src/TransportClass.h \
+	src/SerialTransportClass.h \
+	src/TcpTransportClass.h \
+	src/DeviceClass.h \
+	src/DeviceManagerClass.h \
+	src/SyncCaptureClass.h \
+	src/DashboardWidget.h \
+	src/ModelClass.h \
+	src/SeriesClass.h \
+	src/SeriesGraphClass.h \
+	src/StatusClass.h \
 	src/qcustomplot.h
 
 FORMS += \
@@ -0,0 +1,191 @@
+#include <math.h>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QTimerEvent>
+#include "Trace.h"
+#include "DashboardWidget.h"
+
+constexpr int DashboardWidget::COLUMNS;
+
+DashboardWidget::DashboardWidget(QWidget *parent) :
+	QWidget(parent)
+{
+	setFrameRate(DEFAULT_FRAME_RATE);
+}
+
+void DashboardWidget::setFrameRate(int fps)
+{
+	if(_frameTimerId >= 0)
+		killTimer(_frameTimerId);
+	_frameTimerId = startTimer(1000 / qMax(1, fps));
+}
+
+void DashboardWidget::setDevicesCount(int count)
+{
+	_panels.resize(count);
+	for(int i = 0; i < count; i++)
+		if(_panels[i].name.text().isEmpty())
+			_panels[i].name.setText(QString("psu%0").arg(i));
+	updateGeometry();
+	update();
+}
+
+void DashboardWidget::setDeviceName(int device, QString name)
+{
+	_panels[device].name.setText(name);
+	_dirty = true;
+}
+
+void DashboardWidget::setDeviceUp(int device, bool up)
+{
+	if(_panels[device].up == up)
+		return;
+	_panels[device].up = up;
+	_dirty = true;
+}
+
+void DashboardWidget::addSample(int device, int channel, double key, float value)
+{
+	if(qIsNaN(value))
+		return;
+	auto &c = _panels[device].channels[channel];
+	c.value = value;
+	qint64 index = floor(key * COLUMNS / HISTORY);
+	if(index == c.lastIndex)
+	{
+		// decimate to the current column
+		auto &column = c.columns[index % COLUMNS];
+		column.min = qMin(column.min, value);
+		column.max = qMax(column.max, value);
+		column.last = value;
+	}
+	else if(index > c.lastIndex)
+	{
+		// skipped columns without samples are left out by count
+		c.count = c.lastIndex < 0 || index - c.lastIndex > COLUMNS ? 1 : qMin(COLUMNS, c.count + (int)(index - c.lastIndex));
+		for(auto i = qMax(c.lastIndex + 1, index - COLUMNS + 1); i <= index; i++)
+		{
+			auto &column = c.columns[i % COLUMNS];
+			column.min = column.max = column.last = i == index ? value : NAN;
+		}
+		c.lastIndex = index;
+	}
+	_lastIndex = qMax(_lastIndex, index);
+	_dirty = true;
+}
+
+void DashboardWidget::timerEvent(QTimerEvent *event)
+{
+	if(event->timerId() != _frameTimerId)
+	{
+		QWidget::timerEvent(event);
+		return;
+	}
+	if(_dirty)
+	{
+		_dirty = false;
+		update();
+	}
+}
+
+int DashboardWidget::columnsCount() const
+{
+	return qMax(1, (width() + SPACING) / (PANEL_WIDTH + SPACING));
+}
+
+QRect DashboardWidget::panelRect(int index) const
+{
+	auto columns = columnsCount();
+	return QRect((index % columns) * (PANEL_WIDTH + SPACING), (index / columns) * (PANEL_HEIGHT + SPACING),
+		PANEL_WIDTH, PANEL_HEIGHT);
+}
+
+QSize DashboardWidget::sizeHint() const
+{
+	int columns = qMax(1, qMin(_panels.size(), 4));
+	int rows = (_panels.size() + columns - 1) / columns;
+	return QSize(columns * (PANEL_WIDTH + SPACING) - SPACING, qMax(1, rows) * (PANEL_HEIGHT + SPACING) - SPACING);
+}
+
+float DashboardWidget::scaleMax(const Channel &channel)
+{
+	float max = 0;
+	for(int i = 0; i < channel.count; i++)
+	{
+		auto &column = channel.columns[(channel.lastIndex - i) % COLUMNS];
+		if(!qIsNaN(column.max))
+			max = qMax(max, column.max);
+	}
+	return max > 0 ? pow(2, ceil(log2(max))) : 1;
+}
+
+void DashboardWidget::paintEvent(QPaintEvent *event)
+{
+	TRACE_SCOPE("gui", "dashboard paint");
+	QPainter painter(this);
+	auto fm = painter.fontMetrics();
+	int textHeight = fm.height();
+
+	// shared by all panels: time ticks positions relative to the sparkline right edge
+	QVector<int> ticks;
+	for(int t = TICK; t < HISTORY; t += TICK)
+		ticks.append(t * COLUMNS / HISTORY);
+
+	QVector<QRect> frames;
+	QVector<QLineF> grid;
+	QVector<QLineF> lines[2];
+	for(int p = 0; p < _panels.size(); p++)
+	{
+		auto rect = panelRect(p);
+		if(!event->rect().intersects(rect))
+			continue;
+		auto &panel = _panels[p];
+		frames.append(rect);
+
+		// readouts
+		painter.drawStaticText(rect.left() + 3, rect.top() + 1, panel.name);
+		auto &u = panel.channels[0], &i = panel.channels[1];
+		painter.drawText(QRect(rect.left(), rect.top() + 1, rect.width() - 3, textHeight), Qt::AlignRight,
+			panel.up ? QString("%1 V  %2 A").arg(u.value, 5, 'f', 2, QLatin1Char('0')).arg(i.value, 5, 'f', 3, QLatin1Char('0'))
+				: QString("--.-- V  -.--- A"));
+
+		// sparklines: columns are scaled to the sparkline width
+		QRectF spark(rect.left() + 2, rect.top() + textHeight + 3, rect.width() - 4, rect.height() - textHeight - 5);
+		double dx = spark.width() / COLUMNS;
+		foreach(int t, ticks)
+			grid.append(QLineF(spark.right() - t * dx, spark.top(), spark.right() - t * dx, spark.bottom()));
+		for(int ch = 0; ch < 2; ch++)
+		{
+			auto &c = panel.channels[ch];
+			double dy = spark.height() / scaleMax(c);
+			float prev = NAN;
+			for(int k = c.count - 1; k >= 0; k--)
+			{
+				auto index = c.lastIndex - k;
+				auto &column = c.columns[index % COLUMNS];
+				if(qIsNaN(column.min))
+				{
+					prev = NAN;
+					continue;
+				}
+				// joined to the previous column: continuous trace of vertical segments
+				auto min = qIsNaN(prev) ? column.min : qMin(column.min, prev);
+				auto max = qIsNaN(prev) ? column.max : qMax(column.max, prev);
+				double x = spark.right() - (_lastIndex - index) * dx;
+				if(x >= spark.left())
+					lines[ch].append(QLineF(x, spark.bottom() - min * dy, x, spark.bottom() - max * dy - 1));
+				prev = column.last;
+			}
+		}
+	}
+
+	// batched by pen
+	painter.setPen(palette().color(QPalette::Mid));
+	painter.drawRects(frames);
+	painter.setPen(QPen(palette().color(QPalette::Midlight), 0, Qt::DotLine));
+	painter.drawLines(grid);
+	painter.setPen(QPen(Qt::blue, 0));
+	painter.drawLines(lines[0]);
+	painter.setPen(QPen(Qt::red, 0));
+	painter.drawLines(lines[1]);
+}
@@ -0,0 +1,85 @@
+#ifndef DashboardWidget_H
+#define DashboardWidget_H
+
+#include <QWidget>
+#include <QVector>
+#include <QString>
+#include <QStaticText>
+
+//! Grid of compact panels of several devices: name, V & A readouts & V/A sparklines
+//! All panels are painted in one pass by a few batched calls: frames, time ticks & sparklines
+//! of all panels share pens & tick positions; samples are decimated to min/max per column
+//! on arrival & repaints are limited to the frame rate
+class DashboardWidget : public QWidget
+{
+	Q_OBJECT
+
+public:
+	static constexpr int DEFAULT_FRAME_RATE = 30; //!< fps
+	static constexpr int HISTORY = 60; //!< Sparkline time depth, s
+	static constexpr int TICK = 10; //!< Sparkline time tick, s
+	static constexpr int COLUMNS = 240; //!< Sparkline decimation columns
+
+	explicit DashboardWidget(QWidget *parent=NULL);
+
+	void setDevicesCount(int count);
+	int devicesCount() const { return _panels.size(); }
+	//! @param name	Example: "psu0 /dev/ttyACM0"
+	void setDeviceName(int device, QString name);
+	//! Not up device readouts are shown as "--.--"
+	void setDeviceUp(int device, bool up);
+
+	//! Adds sample to the device sparkline
+	//! @param channel	0 - V; 1 - A
+	//! @param key	Time, s
+	void addSample(int device, int channel, double key, float value);
+
+	void setFrameRate(int fps);
+
+	QSize sizeHint() const override;
+
+protected:
+	static constexpr int PANEL_WIDTH = 220; //!< px
+	static constexpr int PANEL_HEIGHT = 72; //!< px
+	static constexpr int SPACING = 4; //!< px
+
+	//! Decimated samples of one time column
+	struct Column
+	{
+		float min;
+		float max;
+		float last;
+	};
+
+	//! Sparkline of one channel: ring of the last COLUMNS columns
+	struct Channel
+	{
+		Column columns[COLUMNS];
+		qint64 lastIndex = -1; //!< Last column time index: -1 - no samples
+		int count = 0; //!< Filled columns: 0..COLUMNS
+		float value = 0; //!< Last sample
+	};
+
+	struct Panel
+	{
+		QStaticText name;
+		bool up = false;
+		Channel channels[2]; //!< V & A
+	};
+
+	QVector<Panel> _panels;
+	qint64 _lastIndex = -1; //!< The latest column time index of all panels: the right edge of sparklines
+	bool _dirty = false; //!< Repaint at the next frame
+	int _frameTimerId = -1;
+
+	void paintEvent(QPaintEvent *event) override;
+	void timerEvent(QTimerEvent *event) override;
+
+	//! @return Panels count in row
+	int columnsCount() const;
+	QRect panelRect(int index) const;
+	//! @return Power of 2 range upper bound for the channel maximum
+	static float scaleMax(const Channel &channel);
+};
+
+#endif // DashboardWidget_H
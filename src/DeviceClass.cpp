@@ -0,0 +1,295 @@
+#include <QTimerEvent>
+#include "Log.h"
+#include "DeviceClass.h"
+
+constexpr int DeviceClass::RING_SIZE;
+constexpr int DeviceClass::SETPOINTS_ROUNDS;
+constexpr int DeviceClass::CYCLE_SIZE;
+constexpr int DeviceClass::DEFAULT_STATUS_INTERVAL;
+
+DeviceClass::DeviceClass(int index, QObject *parent) :
+	ProtocolClass(parent), _index(index)
+{
+	qRegisterMetaType<StatusClass::Event>();
+	// own signals are dispatched directly in the I/O thread
+	connect(this, SIGNAL(modelDetected(QString)), SLOT(_modelDetected()));
+	connect(this, SIGNAL(answerValue(ProtocolClass::RequestEnum,float)),
+		SLOT(_answerValue(ProtocolClass::RequestEnum,float)));
+	connect(this, SIGNAL(answer(ProtocolClass::RequestEnum,QByteArray)),
+		SLOT(_answer(ProtocolClass::RequestEnum,QByteArray)));
+}
+
+void DeviceClass::portOpened()
+{
+	// the link may differ from the previous one
+	_minRoundTrip = 0;
+	_linkDelay.store(0, std::memory_order_relaxed);
+	ProtocolClass::portOpened();
+}
+
+void DeviceClass::portClosed()
+{
+	_up.store(false, std::memory_order_relaxed);
+	_roundActive = false;
+	_cycleLength = 0;
+	// the status of the next connection isn't an edge
+	_statusPending = false;
+	_sinceStatus = 0;
+	_status.store(-1, std::memory_order_relaxed);
+	_outputRequest = RequestEnum::None;
+	_outputPending = false;
+	if(_nextTimerId >= 0)
+	{
+		killTimer(_nextTimerId);
+		_nextTimerId = -1;
+	}
+	ProtocolClass::portClosed();
+}
+
+void DeviceClass::timerEvent(QTimerEvent *event)
+{
+	if(event->timerId() == _nextTimerId)
+	{
+		killTimer(_nextTimerId);
+		_nextTimerId = -1;
+		request(_nextRequest);
+	}
+	else
+		ProtocolClass::timerEvent(event);
+}
+
+void DeviceClass::next(RequestEnum r)
+{
+	auto model = this->model();
+	if(!model || !model->requestInterval)
+	{
+		request(r);
+		return;
+	}
+	_nextRequest = r;
+	if(_nextTimerId < 0)
+		_nextTimerId = startTimer(model->requestInterval, Qt::PreciseTimer);
+}
+
+void DeviceClass::appendCycle(bool setpoints)
+{
+	static const RequestEnum SETPOINTS[2][2] =
+		{ { RequestEnum::VSET1Q, RequestEnum::ISET1Q }, { RequestEnum::VSET2Q, RequestEnum::ISET2Q } };
+	static const RequestEnum OUTPUTS[2][2] =
+		{ { RequestEnum::VOUT1Q, RequestEnum::IOUT1Q }, { RequestEnum::VOUT2Q, RequestEnum::IOUT2Q } };
+	auto model = this->model();
+	int channels = model ? qMin(model->channels, 2) : 1;
+	for(int ch = 0; ch < channels; ch++)
+		for(auto r : setpoints ? SETPOINTS[ch] : OUTPUTS[ch])
+			_cycle[_cycleLength++] = r;
+}
+
+void DeviceClass::_modelDetected()
+{
+	_up.store(true, std::memory_order_relaxed);
+	auto model = this->model();
+	if(_tracking >= 0 && model && model->supports(ModelClass::Tracking))
+		// no answer
+		request((RequestEnum)((int)RequestEnum::TRACK0 + _tracking));
+	// start the polling cycle; rounds are started by startRound()
+	if(_roundMode)
+		return;
+	// outputs of all channels follow each other: one plot row per cycle
+	_cycleLength = 0;
+	appendCycle(true);
+	appendCycle(false);
+	_cyclePos = 0;
+	_cycleTimestamp = 0;
+	next(_cycle[0]);
+}
+
+void DeviceClass::startRound()
+{
+	if(!isUp())
+		return;
+	if(_roundActive)
+	{
+		_skippedRounds.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	_roundActive = true;
+	_round++;
+	// measurements are the closest to the round start
+	_cycleLength = 0;
+	appendCycle(false);
+	if(_round % SETPOINTS_ROUNDS == 1)
+		appendCycle(true);
+	_cyclePos = 0;
+	_cycleTimestamp = 0;
+	request(_cycle[0]);
+}
+
+void DeviceClass::setOutput(bool on)
+{
+	if(!isUp())
+		return;
+	_outputRequest = on ? RequestEnum::OUT1 : RequestEnum::OUT0;
+	if(_cycleLength && (!_roundMode || _roundActive))
+		// sent by the cycle between its requests
+		return;
+	auto r = _outputRequest;
+	_outputRequest = RequestEnum::None;
+	request(r);
+}
+
+quint64 DeviceClass::answerTimestamp()
+{
+	// PSU measures on request arrival: the minimum round trip has no queueing, half of it is one-way delay
+	if(_lastRxTime > 0 && (!_minRoundTrip || (quint64)_lastRxTime < _minRoundTrip))
+	{
+		_minRoundTrip = _lastRxTime;
+		_linkDelay.store(_minRoundTrip / 2, std::memory_order_relaxed);
+	}
+	return _requestTimestamp + _minRoundTrip / 2;
+}
+
+void DeviceClass::_answerValue(ProtocolClass::RequestEnum r, float value)
+{
+	auto timestamp = answerTimestamp();
+	// the first answer stamps the cycle, even if the first request of the cycle timed out
+	if(!_cycleTimestamp)
+		_cycleTimestamp = timestamp;
+	push(r, value, timestamp, _cycleTimestamp);
+
+	// the next request of the polling cycle; other answers don't move the cycle
+	if(!_cycleLength || _statusPending || r != _cycle[_cyclePos])
+		return;
+	_cyclePos++;
+	_sinceStatus++;
+	resume();
+}
+
+void DeviceClass::resume()
+{
+	if(_outputRequest != RequestEnum::None)
+	{
+		// output switch isn't answered: its answer() resumes the cycle
+		auto r = _outputRequest;
+		_outputRequest = RequestEnum::None;
+		_outputPending = true;
+		next(r);
+		return;
+	}
+	auto model = this->model();
+	if(_statusInterval > 0 && _sinceStatus >= _statusInterval && model && model->supports(ModelClass::Status))
+	{
+		// edges are detected within the status interval
+		_sinceStatus = 0;
+		_statusPending = true;
+		next(RequestEnum::STATUSQ);
+		return;
+	}
+	if(_roundMode && _cyclePos >= _cycleLength)
+	{
+		_roundActive = false;
+		return;
+	}
+	if(_cyclePos >= _cycleLength)
+	{
+		// the next cycle
+		_cyclePos = 0;
+		_cycleTimestamp = 0;
+	}
+	next(_cycle[_cyclePos]);
+}
+
+void DeviceClass::resynced()
+{
+	// the pending request isn't known to the protocol: the cycle resumes from it
+	if(!_cycleLength || (_roundMode && !_roundActive))
+		return;
+	_statusPending = false;
+	resume();
+}
+
+void DeviceClass::_answer(ProtocolClass::RequestEnum r, QByteArray value)
+{
+	if(r == RequestEnum::OUT0 || r == RequestEnum::OUT1)
+	{
+		// the status poll following the output off reports it without a trip
+		if(r == RequestEnum::OUT0)
+			_outputOffRequested = true;
+		if(_outputPending)
+		{
+			_outputPending = false;
+			resume();
+		}
+		return;
+	}
+	if(r != RequestEnum::STATUSQ)
+		return;
+	auto timestamp = answerTimestamp();
+	if(value.size() == 1)
+	{
+		StatusClass status((quint8)value[0]);
+		auto previous = _status.exchange(status.bits(), std::memory_order_relaxed);
+		if(previous >= 0)
+		{
+			QVector<StatusClass::Event> events;
+			auto model = this->model();
+			status.edges(StatusClass((quint8)previous), model ? model->channels : 1, _outputOffRequested,
+				timestamp, timestamp - _statusTimestamp, &events);
+			if(!events.isEmpty())
+			{
+				// the edge may be right after the previous status instant
+				auto latency = (Log::timestamp() - _statusTimestamp) / 1000;
+				{
+					QMutexLocker locker(&_statisticsMutex);
+					_statistics.statusEvents += events.size();
+					_statistics.statusEventLatency.record(latency);
+				}
+				foreach(auto &event, events)
+				{
+					LOG_INFO_ARGS(Protocol, "%0 CH%1 at %2 us (window %3 us, status %4)", StatusClass::eventName(event.type),
+						event.channel + 1, event.timestamp / 1000, event.window / 1000, status.bits());
+					emit statusEvent(event);
+				}
+			}
+		}
+		_statusTimestamp = timestamp;
+		_outputOffRequested = false;
+	}
+	else
+	{
+		QMutexLocker locker(&_statisticsMutex);
+		_statistics.parseFailures++;
+	}
+
+	if(!_statusPending)
+		return;
+	_statusPending = false;
+	if(_cycleLength)
+		resume();
+}
+
+void DeviceClass::push(ProtocolClass::RequestEnum r, float value, quint64 timestamp, quint64 cycle)
+{
+	auto head = _head.load(std::memory_order_relaxed);
+	if(head - _tail.load(std::memory_order_acquire) >= (quint32)RING_SIZE)
+	{
+		// consumer stalls: keep the unread samples
+		_overflows.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	auto &sample = _ring[head & (RING_SIZE - 1)];
+	sample.timestamp = timestamp;
+	sample.request = r;
+	sample.value = value;
+	sample.cycle = cycle;
+	_head.store(head + 1, std::memory_order_release);
+}
+
+bool DeviceClass::pop(Sample *sample)
+{
+	auto tail = _tail.load(std::memory_order_relaxed);
+	if(tail == _head.load(std::memory_order_acquire))
+		return false;
+	*sample = _ring[tail & (RING_SIZE - 1)];
+	_tail.store(tail + 1, std::memory_order_release);
+	return true;
+}
@@ -0,0 +1,122 @@
+#ifndef DeviceClass_H
+#define DeviceClass_H
+
+#include <atomic>
+#include "ProtocolClass.h"
+#include "StatusClass.h"
+
+//! PSU driven by an I/O thread of DeviceManagerClass: runs the polling cycle in the I/O thread
+//! at the model safe request rate & publishes samples to the ring read by GUI thread, without queued signal per sample
+//! Aligned to cache line: per-device state of devices sharing a thread & the ring indices don't share lines
+class alignas(64) DeviceClass : public ProtocolClass
+{
+	Q_OBJECT
+
+public:
+	//! Polled value
+	struct Sample
+	{
+		quint64 timestamp; //!< PSU measurement instant estimate: request sent + link delay, Log::timestamp(), ns
+		ProtocolClass::RequestEnum request; //!< VSETnQ, ISETnQ, VOUTnQ or IOUTnQ
+		float value; //!< NAN if answer can't be parsed
+		quint64 cycle; //!< Polling cycle or round start instant estimate: the first answer of the cycle, ns
+	};
+
+	static constexpr int RING_SIZE = 1024; //!< Samples ring capacity: power of 2
+	static constexpr int SETPOINTS_ROUNDS = 10; //!< Setpoints are polled every N rounds in round mode
+	static constexpr int DEFAULT_STATUS_INTERVAL = 4; //!< STATUS? is interleaved after every N cycle requests
+
+	explicit DeviceClass(int index, QObject *parent=NULL);
+
+	int index() const { return _index; }
+	//! @return PSU model is detected; thread-safe
+	bool isUp() const { return _up.load(std::memory_order_relaxed); }
+
+	//! Takes the oldest sample from the ring; called by the only consumer thread
+	//! @return false if the ring is empty
+	bool pop(Sample *sample);
+	//! @return Samples dropped since the ring was full; thread-safe
+	quint64 overflows() const { return _overflows.load(std::memory_order_relaxed); }
+	//! @return Rounds skipped since the previous round wasn't complete; thread-safe
+	quint64 skippedRounds() const { return _skippedRounds.load(std::memory_order_relaxed); }
+	//! @return One-way link delay estimate, ns; thread-safe
+	quint64 linkDelay() const { return _linkDelay.load(std::memory_order_relaxed); }
+	//! @return The last polled status: -1 - not polled yet; 0..255 - StatusClass bits; thread-safe
+	int status() const { return _status.load(std::memory_order_relaxed); }
+
+	//! Polls by rounds started by startRound() instead of free running cycle; call before start
+	void setRoundMode(bool roundMode) { _roundMode = roundMode; }
+	//! Sets multichannel mode on model detection; ignored by single channel models; call before start
+	//! @param mode	-1 - keep PSU mode; 0 - independent; 1 - series; 2 - parallel
+	void setTracking(int mode) { _tracking = mode; }
+	//! Interleaves STATUS? into the polling cycle; ignored by models without STATUS?; call before start
+	//! @param requests	Cycle requests between status polls: 0 - status isn't polled
+	void setStatusInterval(int requests) { _statusInterval = requests; }
+
+signals:
+	//! Status edge detected by the status poll; emitted in the I/O thread
+	void statusEvent(StatusClass::Event event);
+
+public slots:
+	//! Polls V & I of all channels (& setpoints every SETPOINTS_ROUNDS rounds) once in round mode
+	void startRound();
+	//! Switches the output by OUT1 or OUT0 between the polling cycle requests; an output off isn't reported as a trip
+	void setOutput(bool on);
+
+protected slots:
+	void _modelDetected();
+	void _answerValue(ProtocolClass::RequestEnum r, float value);
+	void _answer(ProtocolClass::RequestEnum r, QByteArray value);
+
+protected:
+	const int _index;
+	std::atomic<bool> _up { false };
+	bool _roundMode = false;
+	int _tracking = -1; //!< Multichannel mode to set: -1 - keep
+	static constexpr int CYCLE_SIZE = 8; //!< The longest cycle: 4 requests per channel
+	RequestEnum _cycle[CYCLE_SIZE]; //!< Free running cycle or the current round requests
+	int _cycleLength = 0;
+	int _cyclePos = 0; //!< Pending request of the cycle
+	quint64 _cycleTimestamp = 0; //!< The cycle start instant estimate, ns: 0 - no answers in the cycle yet
+	bool _roundActive = false; //!< Round requests are pending
+	quint64 _round = 0; //!< Started rounds count
+	std::atomic<quint64> _skippedRounds { 0 };
+	RequestEnum _nextRequest = RequestEnum::None; //!< Request delayed by the model request interval
+	int _nextTimerId = -1; //!< Delayed request timer ID: -1 - timer not launched; 0..
+	quint64 _minRoundTrip = 0; //!< Since port opened, ns: 0 - no answers yet
+	std::atomic<quint64> _linkDelay { 0 }; //!< ns
+	int _statusInterval = DEFAULT_STATUS_INTERVAL; //!< Cycle requests between status polls: 0 - not polled
+	int _sinceStatus = 0; //!< Cycle requests answered since the status poll
+	bool _statusPending = false; //!< Interleaved status poll is pending: its answer resumes the cycle
+	bool _outputOffRequested = false; //!< OUT0 sent since the status poll
+	RequestEnum _outputRequest = RequestEnum::None; //!< OUT0 or OUT1 to send before the next cycle request
+	bool _outputPending = false; //!< Output switch of the cycle is sent: its answer resumes the cycle
+	quint64 _statusTimestamp = 0; //!< The last status instant estimate, ns
+	std::atomic<int> _status { -1 };
+
+	alignas(64) std::atomic<quint32> _head { 0 }; //!< Next sample to write; written by I/O thread
+	std::atomic<quint64> _overflows { 0 }; //!< Written by I/O thread
+	alignas(64) std::atomic<quint32> _tail { 0 }; //!< Next sample to read; written by consumer thread
+	alignas(64) Sample _ring[RING_SIZE];
+
+	void portOpened() override;
+	void portClosed() override;
+	void timerEvent(QTimerEvent *event) override;
+	//! Resends the pending request of the cycle
+	void resynced() override;
+
+	//! Sends the next request of the cycle after the model request interval
+	void next(RequestEnum r);
+	//! Sends the pending request of the cycle, interleaving status poll; ends the round at the cycle end
+	void resume();
+	//! @return The answer instant estimate: request sent + link delay, ns; updates the link delay estimate
+	quint64 answerTimestamp();
+	//! Appends channels requests to the cycle
+	//! @param setpoints	true - VSETnQ, ISETnQ; false - VOUTnQ, IOUTnQ
+	void appendCycle(bool setpoints);
+
+	//! Appends the sample to the ring; drops it if the ring is full
+	void push(ProtocolClass::RequestEnum r, float value, quint64 timestamp, quint64 cycle);
+};
+
+#endif // DeviceClass_H
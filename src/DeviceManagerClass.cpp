@@ -0,0 +1,78 @@
+#include "Log.h"
+#include "Trace.h"
+#include "DeviceManagerClass.h"
+
+constexpr int DeviceManagerClass::DEFAULT_THREADS;
+
+DeviceManagerClass::DeviceManagerClass(QObject *parent) :
+	QObject(parent)
+{
+}
+
+DeviceManagerClass::~DeviceManagerClass()
+{
+	stop();
+}
+
+QString DeviceManagerClass::threadName(int index)
+{
+	return QString("io%0").arg(index);
+}
+
+DeviceClass *DeviceManagerClass::addDevice()
+{
+	// devices must not have parent since they're moved to I/O threads
+	auto device = new DeviceClass(_devices.size());
+	device->setObjectName(QString("psu%0").arg(device->index()));
+	_devices.append(device);
+	return device;
+}
+
+void DeviceManagerClass::start(int threadsCount)
+{
+	threadsCount = qBound(1, threadsCount, qMax(1, _devices.size()));
+	for(int i = 0; i < threadsCount; i++)
+	{
+		auto thread = new QThread(this);
+		auto name = threadName(i);
+		thread->setObjectName(name);
+		connect(thread, &QThread::started, thread, [name] { Trace::setThreadName(name); },
+			Qt::DirectConnection);
+		_threads.append(thread);
+	}
+	foreach(auto device, _devices)
+	{
+		auto thread = _threads[device->index() % threadsCount];
+		device->moveToThread(thread);
+		connect(thread, SIGNAL(finished()), device, SLOT(deleteLater()));
+	}
+	foreach(auto thread, _threads)
+		thread->start();
+	LOG_INFO(Protocol, QString("%0 devices on %1 I/O threads").arg(_devices.size()).arg(threadsCount));
+}
+
+void DeviceManagerClass::stop()
+{
+	if(_threads.isEmpty())
+	{
+		// not started
+		qDeleteAll(_devices);
+		_devices.clear();
+		return;
+	}
+	foreach(auto device, _devices)
+		QMetaObject::invokeMethod(device, "stop", Qt::BlockingQueuedConnection);
+	foreach(auto thread, _threads)
+		thread->quit();
+	foreach(auto thread, _threads)
+		thread->wait();
+	qDeleteAll(_threads);
+	_threads.clear();
+	_devices.clear();
+}
+
+void DeviceManagerClass::dumpStatistics()
+{
+	foreach(auto device, _devices)
+		QMetaObject::invokeMethod(device, "dumpStatistics", Qt::QueuedConnection);
+}
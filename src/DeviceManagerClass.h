@@ -0,0 +1,46 @@
+#ifndef DeviceManagerClass_H
+#define DeviceManagerClass_H
+
+#include <QObject>
+#include <QVector>
+#include <QThread>
+#include "DeviceClass.h"
+
+//! Drives N PSUs on a small pool of I/O event loop threads: devices are distributed round-robin,
+//! each thread serves several devices instead of thread per device
+class DeviceManagerClass : public QObject
+{
+	Q_OBJECT
+
+public:
+	static constexpr int DEFAULT_THREADS = 4; //!< I/O threads count limit
+
+	explicit DeviceManagerClass(QObject *parent=NULL);
+	~DeviceManagerClass();
+
+	//! Creates the device; configure it before start()
+	DeviceClass *addDevice();
+	int devicesCount() const { return _devices.size(); }
+	DeviceClass *device(int index) const { return _devices[index]; }
+
+	//! Moves devices to I/O threads & starts the threads
+	//! @param threadsCount	I/O threads count limit: 1..; devices count at most
+	void start(int threadsCount = DEFAULT_THREADS);
+	//! Stops devices & I/O threads
+	void stop();
+
+	int threadsCount() const { return _threads.size(); }
+	QThread *thread(int index) const { return _threads[index]; }
+	//! @return I/O thread name for trace & watchdog, example: "io0"
+	static QString threadName(int index);
+
+public slots:
+	//! Writes statistics of all devices to log & statistics files
+	void dumpStatistics();
+
+protected:
+	QVector<DeviceClass *> _devices; //!< Deleted by own thread on finish
+	QVector<QThread *> _threads;
+};
+
+#endif // DeviceManagerClass_H
@@ -0,0 +1,199 @@
+#include <QSocketNotifier>
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QMap>
+#include "HotplugClass.h"
+#include "Log.h"
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/inotify.h>
+#include <linux/netlink.h>
+#endif
+
+static constexpr int UDEV_MONITOR_GROUP = 2; //!< Netlink group of events processed by udev
+static constexpr const char *UDEV_CONTROL = "/run/udev/control"; //!< udev daemon control socket: exists while it runs
+static constexpr int BUFFER_SIZE = 8192; //!< Netlink message or inotify events buffer, bytes
+
+HotplugClass::HotplugClass(QObject *parent) :
+	QObject(parent)
+{
+}
+
+HotplugClass::~HotplugClass()
+{
+	close();
+}
+
+void HotplugClass::close()
+{
+	delete _notifier;
+	_notifier = nullptr;
+#ifdef Q_OS_LINUX
+	if(_fd >= 0)
+		::close(_fd);
+#endif
+	_fd = -1;
+}
+
+bool HotplugClass::startNetlink()
+{
+#ifdef Q_OS_LINUX
+	close();
+	// bind succeeds without udev daemon too (example: container), but no udev events are broadcast then
+	if(!QFileInfo::exists(UDEV_CONTROL))
+	{
+		LOG_DEBUG(Serial, "hotplug: udev isn't running");
+		return false;
+	}
+	_fd = ::socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_KOBJECT_UEVENT);
+	if(_fd < 0)
+		return false;
+	struct sockaddr_nl address = {};
+	address.nl_family = AF_NETLINK;
+	address.nl_groups = UDEV_MONITOR_GROUP;
+	if(::bind(_fd, (struct sockaddr *)&address, sizeof(address)))
+	{
+		close();
+		return false;
+	}
+	_netlink = true;
+	_notifier = new QSocketNotifier(_fd, QSocketNotifier::Read, this);
+	connect(_notifier, SIGNAL(activated(int)), SLOT(_notifier_activated()));
+	LOG_INFO(Serial, "hotplug: udev netlink");
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool HotplugClass::startInotify(QString directory)
+{
+#ifdef Q_OS_LINUX
+	close();
+	_fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if(_fd < 0)
+		return false;
+	// attributes change: device node permissions are set after creation
+	if(::inotify_add_watch(_fd, QFile::encodeName(directory).constData(), IN_CREATE | IN_ATTRIB) < 0)
+	{
+		close();
+		return false;
+	}
+	_netlink = false;
+	_directory = directory;
+	_notifier = new QSocketNotifier(_fd, QSocketNotifier::Read, this);
+	connect(_notifier, SIGNAL(activated(int)), SLOT(_notifier_activated()));
+	LOG_INFO(Serial, QString("hotplug: inotify ") + directory);
+	return true;
+#else
+	Q_UNUSED(directory)
+	return false;
+#endif
+}
+
+void HotplugClass::_notifier_activated()
+{
+#ifdef Q_OS_LINUX
+	QByteArray buff(BUFFER_SIZE, Qt::Uninitialized);
+	for(;;)
+	{
+		auto length = ::read(_fd, buff.data(), buff.size());
+		if(length <= 0)
+			break;
+		if(_netlink)
+			processNetlink(buff.left(length));
+		else
+			processInotify(buff.left(length));
+	}
+#endif
+}
+
+void HotplugClass::processNetlink(const QByteArray &message)
+{
+	// udev message: "libudev" header, followed by NUL separated KEY=VALUE properties
+	// kernel message: "ACTION@DEVPATH", followed by the same properties
+	static constexpr int UDEV_HEADER_PROPERTIES_OFFSET = 16; //!< Offset of properties offset & length fields
+	int offset;
+	if(message.startsWith("libudev"))
+	{
+		if(message.length() < UDEV_HEADER_PROPERTIES_OFFSET + 8)
+			return;
+		offset = *(const quint32 *)(message.constData() + UDEV_HEADER_PROPERTIES_OFFSET);
+	}
+	else
+		offset = message.indexOf('\0') + 1;
+	if(offset <= 0 || offset >= message.length())
+		return;
+
+	QMap<QByteArray, QByteArray> properties;
+	foreach(auto property, message.mid(offset).split('\0'))
+	{
+		auto pos = property.indexOf('=');
+		if(pos > 0)
+			properties.insert(property.left(pos), property.mid(pos + 1));
+	}
+	if(properties.value("ACTION") != "add" || properties.value("SUBSYSTEM") != "tty" || !properties.contains("DEVNAME"))
+		return;
+
+	auto portName = QFileInfo(QString::fromUtf8(properties.value("DEVNAME"))).fileName();
+	bool vidOk, pidOk;
+	int vid = properties.value("ID_VENDOR_ID").toInt(&vidOk, 16), pid = properties.value("ID_MODEL_ID").toInt(&pidOk, 16);
+	if(vidOk && pidOk)
+		portAppeared(portName, vid, pid);
+	else
+		portAppeared(portName, -1, -1);
+}
+
+void HotplugClass::processInotify(const QByteArray &events)
+{
+#ifdef Q_OS_LINUX
+	int pos = 0;
+	while(pos + (int)sizeof(struct inotify_event) <= events.length())
+	{
+		auto event = (const struct inotify_event *)(events.constData() + pos);
+		pos += sizeof(struct inotify_event) + event->len;
+		if(!event->len)
+			continue;
+		QString name = QFile::decodeName(event->name);
+		if(_directory == "/dev")
+		{
+			if(name.startsWith("tty"))
+				portAppeared(name, -1, -1);
+		}
+		else
+			portAppeared(QDir(_directory).filePath(name), -1, -1);
+	}
+#else
+	Q_UNUSED(events)
+#endif
+}
+
+void HotplugClass::portAppeared(QString portName, int vid, int pid)
+{
+	if(vid < 0 && !vidPid(portName, &vid, &pid))
+		vid = pid = -1;
+	LOG_DEBUG(Serial, QString("hotplug: %0 %1:%2").arg(portName)
+		.arg(vid, 4, 16, QLatin1Char('0')).arg(pid, 4, 16, QLatin1Char('0')));
+	emit portAdded(portName, vid, pid);
+}
+
+bool HotplugClass::vidPid(QString portName, int *vid, int *pid)
+{
+	// USB device directory is the parent of tty device (ttyACM) or of it's parent (ttyUSB)
+	auto path = QFileInfo(QString("/sys/class/tty/%0/device").arg(QFileInfo(portName).fileName())).canonicalFilePath();
+	for(int i = 0; i < 3 && !path.isEmpty(); i++, path = QFileInfo(path).path())
+	{
+		QFile vidFile(path + "/idVendor"), pidFile(path + "/idProduct");
+		if(vidFile.open(QIODevice::ReadOnly) && pidFile.open(QIODevice::ReadOnly))
+		{
+			bool vidOk, pidOk;
+			*vid = vidFile.readAll().trimmed().toInt(&vidOk, 16);
+			*pid = pidFile.readAll().trimmed().toInt(&pidOk, 16);
+			return vidOk && pidOk;
+		}
+	}
+	return false;
+}
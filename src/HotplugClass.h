@@ -0,0 +1,56 @@
+#ifndef HotplugClass_H
+#define HotplugClass_H
+
+#include <QObject>
+#include <QString>
+
+class QSocketNotifier;
+
+//! Serial ports hotplug monitor (Linux)
+//! Listens to udev netlink events of tty subsystem; falls back to inotify on the devices directory
+class HotplugClass : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit HotplugClass(QObject *parent=NULL);
+	~HotplugClass();
+
+	//! Starts udev netlink monitor
+	//! @return false if udev daemon isn't running: no events would be delivered
+	bool startNetlink();
+
+	//! Starts to watch the directory for created device nodes
+	//! @param directory	Example: /dev; /dev/pts
+	bool startInotify(QString directory);
+
+	bool isActive() const { return _fd >= 0; }
+
+	//! Reads USB VID:PID of tty device from sysfs
+	//! @param portName	Example: ttyACM0
+	//! @return false if not USB device
+	static bool vidPid(QString portName, int *vid, int *pid);
+
+signals:
+	//! Port is appeared
+	//! @param portName	Example: ttyACM0, or path for watched directory other than /dev
+	//! @param vid	USB VID: -1 - not known
+	//! @param pid	USB PID: -1 - not known
+	void portAdded(QString portName, int vid, int pid);
+
+protected slots:
+	void _notifier_activated();
+
+protected:
+	int _fd = -1; //!< Netlink or inotify descriptor: -1 - not started
+	bool _netlink = false; //!< Netlink or inotify
+	QString _directory; //!< Inotify watched directory
+	QSocketNotifier *_notifier = nullptr;
+
+	void close();
+	void processNetlink(const QByteArray &message);
+	void processInotify(const QByteArray &events);
+	void portAppeared(QString portName, int vid, int pid);
+};
+
+#endif // HotplugClass_H
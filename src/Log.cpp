@@ -0,0 +1,455 @@
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <string.h>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QFile>
+#include <QVector>
+#include "Log.h"
+
+static constexpr char BINARY_MAGIC[8] = { 'K', 'P', 'S', 'U', 'L', 'O', 'G', '1' }; //!< Binary log file signature
+static constexpr int FLUSH_INTERVAL = 20; //!< Background thread writes interval, ms
+static constexpr size_t RING_CAPACITY = 1 << 16; //!< Per-thread buffer size, bytes; power of 2
+static constexpr size_t MAX_RECORD_DATA = 1024; //!< Record data is truncated to, bytes
+
+//! Record header, followed by data
+struct RecordHeader
+{
+	quint64 timestamp; //!< Since log start, ns
+	quint32 thread; //!< Thread index: 0..
+	quint16 length; //!< Data length, bytes
+	quint8 format; //!< Log::FormatEnum
+	quint8 send; //!< Data direction: 1 - TX; 0 - RX
+};
+
+struct Record
+{
+	RecordHeader header;
+	QByteArray data;
+};
+
+static QString _toEscapedCString(const QByteArray &buff)
+{
+	QString ret;
+	ret.reserve(buff.length());
+	foreach(auto ch, buff) {
+		switch(ch)
+		{
+			case 0: ret += "\\0"; break;
+			case 7: ret += "\\a"; break;
+			case 8: ret += "\\b"; break;
+			case 9: ret += "\\t"; break;
+			case 0xa: ret += "\\n"; break;
+			case 0xb: ret += "\\v"; break;
+			case 0xc: ret += "\\f"; break;
+			case 0xd: ret += "\\r"; break;
+			default:
+				if(ch < 0x20 || (uint8_t)ch > 0x7E)
+				{
+					QByteArray a(&ch, 1);
+					ret += QString("\\x") + a.toHex().toUpper();
+				}
+				else
+					ret += ch;
+			break;
+		}
+	}
+	return ret;
+}
+
+//! @return Text of the format string & typed arguments, see Log::ArgsClass
+static QString _formatArgs(const QByteArray &data)
+{
+	QString ret;
+	bool first = true;
+	int pos = 0;
+	while(pos < data.length())
+	{
+		auto tag = (Log::ArgsClass::TagEnum)data[pos++];
+		QString arg;
+		switch(tag)
+		{
+			case Log::ArgsClass::Int:
+			{
+				qint64 v;
+				if(pos + (int)sizeof(v) > data.length())
+					return ret;
+				memcpy(&v, data.constData() + pos, sizeof(v));
+				pos += sizeof(v);
+				arg = QString::number(v);
+				break;
+			}
+			case Log::ArgsClass::UInt:
+			{
+				quint64 v;
+				if(pos + (int)sizeof(v) > data.length())
+					return ret;
+				memcpy(&v, data.constData() + pos, sizeof(v));
+				pos += sizeof(v);
+				arg = QString::number(v);
+				break;
+			}
+			case Log::ArgsClass::Double:
+			{
+				double v;
+				if(pos + (int)sizeof(v) > data.length())
+					return ret;
+				memcpy(&v, data.constData() + pos, sizeof(v));
+				pos += sizeof(v);
+				arg = QString::number(v);
+				break;
+			}
+			case Log::ArgsClass::String:
+			{
+				if(pos >= data.length())
+					return ret;
+				int length = (quint8)data[pos++];
+				arg = QString::fromUtf8(data.constData() + pos, qMin(length, data.length() - pos));
+				pos += length;
+				break;
+			}
+			default:
+				// broken record
+				return ret;
+		}
+		// the first argument is the format
+		if(first)
+			ret = arg;
+		else
+			ret = ret.arg(arg);
+		first = false;
+	}
+	return ret;
+}
+
+//! Formats record to text line
+//! @param startTime	Log start time, ms since epoch
+static std::string _format(const Record &r, qint64 startTime)
+{
+	auto ret = QDateTime::fromMSecsSinceEpoch(startTime + r.header.timestamp / 1000000).toString("hh:mm:ss.zzz ");
+	switch((Log::FormatEnum)r.header.format)
+	{
+		case Log::FormatEnum::Error:
+			ret += '<' + QString::fromUtf8(r.data) + '>';
+			break;
+		case Log::FormatEnum::Msg:
+			ret += QString::fromUtf8(r.data);
+			break;
+		case Log::FormatEnum::Data:
+			ret += QString("%0 %1 ").arg(r.data.length(), 2, 10, QLatin1Char('0')).arg(r.header.send ? ">>" : "<<")
+				+ _toEscapedCString(r.data);
+			break;
+		case Log::FormatEnum::Args:
+			ret += _formatArgs(r.data);
+			break;
+	}
+	ret += '\n';
+	return ret.toStdString();
+}
+
+//! Single producer (thread that logs) & single consumer (background thread) lock-free buffer
+class RingClass
+{
+public:
+	explicit RingClass(quint32 thread) : thread(thread) {}
+
+	const quint32 thread; //!< Thread index: 0..; reused by a later thread after the thread exit
+
+	bool push(const RecordHeader &header, const char *data)
+	{
+		size_t size = sizeof(header) + header.length;
+		auto head = _head.load(std::memory_order_relaxed);
+		if(RING_CAPACITY - (head - _tail.load(std::memory_order_acquire)) < size)
+		{
+			// buffer is full: the background thread lags
+			_dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		copyIn(head, &header, sizeof(header));
+		copyIn(head + sizeof(header), data, header.length);
+		_head.store(head + size, std::memory_order_release);
+		return true;
+	}
+
+	void pop(QVector<Record> &records)
+	{
+		auto tail = _tail.load(std::memory_order_relaxed);
+		auto head = _head.load(std::memory_order_acquire);
+		while(tail != head)
+		{
+			Record r;
+			copyOut(tail, &r.header, sizeof(r.header));
+			r.data.resize(r.header.length);
+			copyOut(tail + sizeof(r.header), r.data.data(), r.header.length);
+			tail += sizeof(r.header) + r.header.length;
+			records.append(r);
+		}
+		_tail.store(tail, std::memory_order_release);
+	}
+
+	//! @return Records count dropped since last call
+	quint32 takeDropped() { return _dropped.exchange(0, std::memory_order_relaxed); }
+
+protected:
+	char _buff[RING_CAPACITY];
+	std::atomic<size_t> _head { 0 }; //!< Write position, written by producer
+	std::atomic<size_t> _tail { 0 }; //!< Read position, written by consumer
+	std::atomic<quint32> _dropped { 0 }; //!< Records count dropped since buffer was full
+
+	void copyIn(size_t pos, const void *data, size_t len)
+	{
+		pos &= RING_CAPACITY - 1;
+		auto first = std::min(len, RING_CAPACITY - pos);
+		memcpy(_buff + pos, data, first);
+		memcpy(_buff, (const char *)data + first, len - first);
+	}
+
+	void copyOut(size_t pos, void *data, size_t len) const
+	{
+		pos &= RING_CAPACITY - 1;
+		auto first = std::min(len, RING_CAPACITY - pos);
+		memcpy(data, _buff + pos, first);
+		memcpy((char *)data + first, _buff, len - first);
+	}
+};
+
+//! Returns the thread buffer to the free list on thread exit
+class RingHolderClass
+{
+public:
+	~RingHolderClass();
+
+	RingClass *ring = nullptr;
+};
+
+static std::atomic<bool> _loggerAlive { false }; //!< Threads may exit after the logger destruction
+
+//! Owns per-thread buffers & the background thread
+class LoggerClass
+{
+public:
+	static LoggerClass &instance()
+	{
+		static LoggerClass logger;
+		return logger;
+	}
+
+	LoggerClass() : _startTime(QDateTime::currentMSecsSinceEpoch())
+	{
+		_timer.start();
+		_thread = std::thread(&LoggerClass::run, this);
+		_loggerAlive = true;
+	}
+
+	~LoggerClass()
+	{
+		_loggerAlive = false;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stop = true;
+		}
+		_wakeUp.notify_one();
+		_thread.join();
+	}
+
+	quint64 timestamp() const { return _timer.nsecsElapsed(); }
+
+	RingClass *ring()
+	{
+		// buffer is taken on first use by the thread: a buffer of an exited thread or a new one
+		thread_local RingHolderClass holder;
+		if(!holder.ring)
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if(!_free.empty())
+			{
+				holder.ring = _free.back();
+				_free.pop_back();
+			}
+			else
+			{
+				_rings.emplace_back(new RingClass(_rings.size()));
+				holder.ring = _rings.back().get();
+			}
+		}
+		return holder.ring;
+	}
+
+	//! Called on thread exit: the remaining records are written by the background thread
+	void release(RingClass *ring)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_free.push_back(ring);
+	}
+
+	bool setBinaryFile(QString fileName)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_binaryFile.close();
+		_binaryFile.setFileName(fileName);
+		if(!_binaryFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+			return false;
+		_binaryFile.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+		_binaryFile.write((const char *)&_startTime, sizeof(_startTime));
+		return true;
+	}
+
+	//! Formats & writes all records: called by the background thread
+	void write()
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		QVector<Record> records;
+		quint32 dropped = 0;
+		for(auto &ring : _rings)
+		{
+			ring->pop(records);
+			dropped += ring->takeDropped();
+		}
+		if(records.isEmpty() && !dropped)
+			return;
+		// merge records of threads
+		std::stable_sort(records.begin(), records.end(),
+			[](const Record &a, const Record &b) { return a.header.timestamp < b.header.timestamp; });
+
+		std::string text;
+		foreach(const Record &r, records)
+		{
+			text += _format(r, _startTime);
+			if(_binaryFile.isOpen())
+			{
+				_binaryFile.write((const char *)&r.header, sizeof(r.header));
+				_binaryFile.write(r.data);
+			}
+		}
+		if(dropped)
+			text += QString("<log: %0 records dropped>\n").arg(dropped).toStdString();
+		// single write & flush per batch
+		std::cout.write(text.data(), text.size());
+		std::cout.flush();
+		if(_binaryFile.isOpen())
+			_binaryFile.flush();
+	}
+
+protected:
+	const qint64 _startTime; //!< Log start time, ms since epoch
+	QElapsedTimer _timer; //!< Monotonic timestamps source
+	std::vector<std::unique_ptr<RingClass>> _rings; //!< Per-thread buffers: as many as threads alive at once
+	std::vector<RingClass*> _free; //!< Buffers of exited threads
+	QFile _binaryFile;
+	std::mutex _mutex; //!< Protects buffers list, binary file & stop flag
+	std::condition_variable _wakeUp;
+	bool _stop = false;
+	std::thread _thread;
+
+	void run()
+	{
+		for(;;)
+		{
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				if(_wakeUp.wait_for(lock, std::chrono::milliseconds(FLUSH_INTERVAL), [this] { return _stop; }))
+					break;
+			}
+			write();
+		}
+		// write remaining records
+		write();
+	}
+};
+
+RingHolderClass::~RingHolderClass()
+{
+	if(ring && _loggerAlive)
+		LoggerClass::instance().release(ring);
+}
+
+std::atomic<Log::LevelEnum> Log::_levels[(int)Log::CategoryEnum::Count]; // zero initialized: Debug, all enabled
+
+bool Log::setLevels(QString levels)
+{
+	static const char *categories[] = { "serial", "protocol", "data", "gui", "watchdog" };
+	static const char *names[] = { "debug", "info", "warning", "error", "none" };
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+	auto items = levels.split(',', Qt::SkipEmptyParts);
+#else
+	auto items = levels.split(',', QString::SkipEmptyParts);
+#endif
+	foreach(auto item, items)
+	{
+		auto pair = item.split('=');
+		if(pair.length() != 2)
+			return false;
+		int category = -1, level = -1;
+		for(int i = 0; i < (int)CategoryEnum::Count; i++)
+			if(pair[0].trimmed() == categories[i])
+				category = i;
+		for(int i = 0; i <= (int)LevelEnum::None; i++)
+			if(pair[1].trimmed() == names[i])
+				level = i;
+		if(category < 0 || level < 0)
+			return false;
+		setLevel((CategoryEnum)category, (LevelEnum)level);
+	}
+	return true;
+}
+
+quint64 Log::timestamp()
+{
+	return LoggerClass::instance().timestamp();
+}
+
+bool Log::setBinaryFile(QString fileName)
+{
+	return LoggerClass::instance().setBinaryFile(fileName);
+}
+
+void Log::flush()
+{
+	LoggerClass::instance().write();
+}
+
+void Log::record(FormatEnum format, const char *data, int length, bool send)
+{
+	auto &logger = LoggerClass::instance();
+	RecordHeader header;
+	header.timestamp = logger.timestamp();
+	auto ring = logger.ring();
+	header.thread = ring->thread;
+	header.length = std::min<size_t>(length, MAX_RECORD_DATA);
+	header.format = (quint8)format;
+	header.send = send;
+	ring->push(header, data);
+}
+
+bool Log::decode(QString fileName, std::ostream &out)
+{
+	QFile file(fileName);
+	if(!file.open(QIODevice::ReadOnly))
+		return false;
+
+	char magic[sizeof(BINARY_MAGIC)];
+	qint64 startTime;
+	if(file.read(magic, sizeof(magic)) != sizeof(magic) || memcmp(magic, BINARY_MAGIC, sizeof(magic))
+		|| file.read((char *)&startTime, sizeof(startTime)) != sizeof(startTime))
+		return false;
+
+	Record r;
+	while(file.read((char *)&r.header, sizeof(r.header)) == sizeof(r.header))
+	{
+		r.data = file.read(r.header.length);
+		if(r.data.length() != r.header.length)
+			// truncated file
+			break;
+		out << _format(r, startTime);
+	}
+	out.flush();
+	return true;
+}
@@ -2,29 +2,279 @@
 #define LOG_H
 
 #include <iostream>
+#include <atomic>
+#include <type_traits>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <string.h>
 #include <QString>
-#include <QDateTime>
+#include <QByteArray>
 
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO 1
+#define LOG_LEVEL_WARNING 2
+#define LOG_LEVEL_ERROR 3
+#define LOG_LEVEL_NONE 4
+
+//! Compile-time minimum level: calls of lower levels vanish, including arguments formatting
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+//! Logger with deferred formatting
+//! Callers only record a timestamp, format id & raw arguments to the per-thread lock-free buffer;
+//! the background thread formats records to text (stdout) and writes binary records to file in batches
 class Log
 {
 public:
-	static inline void error(QString msg)
+	enum class FormatEnum : quint8
+	{
+		Error, //!< Text in angle brackets, example: "<opened ttyACM0>"
+		Msg, //!< Text
+		Data, //!< Raw serial port data: length, direction & escaped data
+		Args, //!< Format string & typed arguments, see args()
+	};
+
+	enum class LevelEnum : quint8
+	{
+		Debug = LOG_LEVEL_DEBUG,
+		Info = LOG_LEVEL_INFO,
+		Warning = LOG_LEVEL_WARNING,
+		Error = LOG_LEVEL_ERROR,
+		None = LOG_LEVEL_NONE,
+	};
+
+	enum class CategoryEnum : quint8
+	{
+		Serial, //!< Serial port open/close/errors
+		Protocol, //!< Requests & answers
+		Data, //!< Raw serial port data
+		Gui, //!< Main window
+		Watchdog, //!< Event loops lag
+
+		Count
+	};
+
+	//! @return Whether the level is compiled in
+	static constexpr bool compiled(LevelEnum level)
+	{
+		return (int)level >= LOG_MIN_LEVEL;
+	}
+
+	//! @return Whether the level is enabled at runtime for the category
+	static bool enabled(CategoryEnum category, LevelEnum level)
+	{
+		return level >= _levels[(int)category].load(std::memory_order_relaxed);
+	}
+
+	//! Sets runtime minimum level of the category
+	static void setLevel(CategoryEnum category, LevelEnum level)
 	{
-		std::cout << qPrintable(QDateTime::currentDateTime().toString("hh:mm:ss.zzz ")) << '<' << qPrintable(msg) << '>' << std::endl;
+		_levels[(int)category].store(level, std::memory_order_relaxed);
+	}
+
+	//! Sets runtime minimum levels from string
+	//! @param levels	Comma separated category=level list, example: "data=none,protocol=warning"
+	//! @return false if string has wrong format
+	static bool setLevels(QString levels);
+
+	//! Allows a call site to log at most once per interval; counts suppressed calls
+	class RateLimitClass
+	{
+	public:
+		//! @param interval	ms
+		explicit RateLimitClass(int interval) : _interval(interval * 1000000LL) {}
+
+		//! @param suppressed	Calls count suppressed since last allowed call
+		bool allow(quint32 &suppressed)
+		{
+			auto now = timestamp();
+			if(now < _next.load(std::memory_order_relaxed))
+			{
+				_suppressed.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			_next.store(now + _interval, std::memory_order_relaxed);
+			suppressed = _suppressed.exchange(0, std::memory_order_relaxed);
+			return true;
+		}
+
+	protected:
+		const quint64 _interval; //!< ns
+		std::atomic<quint64> _next { 0 }; //!< Next allowed call timestamp, ns
+		std::atomic<quint32> _suppressed { 0 };
+	};
+
+	//! Rate limits of a call site by object: each object logs at most once per interval,
+	//! so a noisy device doesn't suppress warnings of others
+	class RateLimitsClass
+	{
+	public:
+		//! @param interval	ms
+		explicit RateLimitsClass(int interval) : _interval(interval) {}
+
+		//! @param key	Object the call is made for, example: this
+		//! @param suppressed	Calls count suppressed for the object since its last allowed call
+		bool allow(const void *key, quint32 &suppressed)
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			auto it = _limits.find(key);
+			if(it == _limits.end())
+				it = _limits.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(_interval)).first;
+			return it->second.allow(suppressed);
+		}
+
+	protected:
+		const int _interval; //!< ms
+		std::mutex _mutex; //!< Protects limits: call sites are shared by threads
+		std::unordered_map<const void *, RateLimitClass> _limits; //!< By key
+	};
+
+	//! Serialized format string & typed arguments: tag & value each; built on the caller stack
+	class ArgsClass
+	{
+	public:
+		static constexpr int CAPACITY = 256; //!< Bytes; arguments beyond are dropped
+
+		enum TagEnum : char
+		{
+			Int = 'i', //!< qint64
+			UInt = 'u', //!< quint64
+			Double = 'd', //!< double
+			String = 's', //!< quint8 length & characters
+		};
+
+		template<typename T>
+		typename std::enable_if<std::is_integral<T>::value>::type append(T value)
+		{
+			if(std::is_signed<T>::value)
+			{
+				qint64 v = value;
+				put(Int, &v, sizeof(v));
+			}
+			else
+			{
+				quint64 v = value;
+				put(UInt, &v, sizeof(v));
+			}
+		}
+		void append(double value) { put(Double, &value, sizeof(value)); }
+		void append(const char *value)
+		{
+			quint8 length = qMin<size_t>(strlen(value), 255);
+			if(put(String, &length, sizeof(length)))
+				put(value, length);
+		}
+
+		const char *data() const { return _buff; }
+		int length() const { return _length; }
+
+	protected:
+		char _buff[CAPACITY];
+		int _length = 0;
+
+		bool put(const void *data, int length)
+		{
+			if(_length + length > CAPACITY)
+				return false;
+			memcpy(_buff + _length, data, length);
+			_length += length;
+			return true;
+		}
+		bool put(TagEnum tag, const void *data, int length)
+		{
+			if(_length + 1 + length > CAPACITY)
+				return false;
+			_buff[_length++] = tag;
+			return put(data, length);
+		}
+	};
+
+	//! Records the format & raw arguments; the background thread formats them by QString::arg()
+	//! The caller doesn't touch the heap: for per-sample & per-request messages
+	//! @param format	Example: "VOUT1 %0"
+	//! @param values	Integers, floating point & C strings (copied, up to 255 characters)
+	template<typename... Args>
+	static void args(const char *format, Args... values)
+	{
+		ArgsClass buff;
+		buff.append(format);
+		(buff.append(values), ...);
+		record(FormatEnum::Args, buff.data(), buff.length());
+	}
+
+	static void error(QString msg)
+	{
+		record(FormatEnum::Error, msg.toUtf8());
 	}
 
 	static void msg(QString msg)
 	{
-		std::cout << qPrintable(QDateTime::currentDateTime().toString("hh:mm:ss.zzz ")) << qPrintable(msg) << std::endl;
+		record(FormatEnum::Msg, msg.toUtf8());
 	}
 
-	static void data(QString data, uint len, bool send=false, bool printTimestamp=true, bool printLen=true)
+	//! @param data	Raw serial port data, escaped by the background thread
+	//! @param send	Direction: true - TX; false - RX
+	static void data(const QByteArray &data, bool send=false)
+	{
+		record(FormatEnum::Data, data.constData(), data.length(), send);
+	}
+	static void data(const char *data, int length, bool send=false)
 	{
-		std::cout << (printTimestamp ? qPrintable(QDateTime::currentDateTime().toString("hh:mm:ss.zzz ")) : "             ")
-			<< (printLen ? qPrintable(QString("%0 %1 ").arg(len, 2, 10, QLatin1Char('0')).arg(send ? ">>" : "<<")) : "      ")
-			<< qPrintable(data)
-			<< std::endl;
+		record(FormatEnum::Data, data, length, send);
 	}
+
+	//! @return Monotonic time since log start, ns
+	static quint64 timestamp();
+
+	//! Starts to write binary records to file, in addition to text on stdout
+	//! @param fileName	Binary log file path
+	static bool setBinaryFile(QString fileName);
+
+	//! Formats & writes all recorded records
+	static void flush();
+
+	//! Decodes binary log file to text
+	//! @return false if file can't be read or has wrong format
+	static bool decode(QString fileName, std::ostream &out);
+
+protected:
+	static std::atomic<LevelEnum> _levels[(int)CategoryEnum::Count]; //!< Runtime minimum levels
+
+	static void record(FormatEnum format, const QByteArray &data, bool send=false)
+	{
+		record(format, data.constData(), data.length(), send);
+	}
+	static void record(FormatEnum format, const char *data, int length, bool send=false);
 };
 
+//! Executes the statement if the level is compiled in & enabled for the category
+#define LOG_IF(category, level, statement) \
+	do { \
+		if(Log::compiled(Log::LevelEnum::level) && Log::enabled(Log::CategoryEnum::category, Log::LevelEnum::level)) \
+			statement; \
+	} while(0)
+
+#define LOG_DEBUG(category, text) LOG_IF(category, Debug, Log::msg(text))
+#define LOG_INFO(category, text) LOG_IF(category, Info, Log::msg(text))
+#define LOG_WARNING(category, text) LOG_IF(category, Warning, Log::msg(text))
+#define LOG_ERROR(category, text) LOG_IF(category, Error, Log::error(text))
+#define LOG_DATA(category, buff, send) LOG_IF(category, Debug, Log::data(buff, send))
+
+//! Like LOG_DEBUG..., but with format & typed arguments formatted by the background thread, see Log::args()
+#define LOG_DEBUG_ARGS(category, ...) LOG_IF(category, Debug, Log::args(__VA_ARGS__))
+#define LOG_INFO_ARGS(category, ...) LOG_IF(category, Info, Log::args(__VA_ARGS__))
+#define LOG_WARNING_ARGS(category, ...) LOG_IF(category, Warning, Log::args(__VA_ARGS__))
+
+//! Like LOG_WARNING, but at most once per interval (ms) for the call site & key object; suppressed calls count is appended
+//! @param key	Object the call is made for, example: this
+#define LOG_WARNING_RATE_LIMITED(category, key, interval, text) \
+	LOG_IF(category, Warning, { \
+		static Log::RateLimitsClass _rateLimits(interval); \
+		quint32 _suppressed; \
+		if(_rateLimits.allow(key, _suppressed)) \
+			Log::msg(_suppressed ? QString(text) + QString(" (%0 suppressed)").arg(_suppressed) : QString(text)); \
+	})
+
 #endif // LOG_H
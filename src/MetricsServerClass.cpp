@@ -0,0 +1,125 @@
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include "MetricsServerClass.h"
+#include "Log.h"
+
+MetricsServerClass::MetricsServerClass(QObject *parent) :
+	QObject(parent)
+{
+}
+
+bool MetricsServerClass::listen(QString address)
+{
+	if(address.startsWith("unix:"))
+	{
+		auto path = address.mid(5);
+		QLocalServer::removeServer(path);
+		_localServer = new QLocalServer(this);
+		connect(_localServer, SIGNAL(newConnection()), SLOT(_server_newConnection()));
+		if(!_localServer->listen(path))
+		{
+			Log::error(QString("metrics: can't listen ") + path + ": " + _localServer->errorString());
+			return false;
+		}
+	}
+	else
+	{
+		QHostAddress host(QHostAddress::LocalHost);
+		auto pos = address.lastIndexOf(':');
+		if(pos >= 0 && !host.setAddress(address.left(pos)))
+		{
+			Log::error(QString("metrics: wrong host ") + address);
+			return false;
+		}
+		bool ok;
+		auto port = address.mid(pos + 1).toUShort(&ok);
+		if(!ok)
+		{
+			Log::error(QString("metrics: wrong port ") + address);
+			return false;
+		}
+		_tcpServer = new QTcpServer(this);
+		connect(_tcpServer, SIGNAL(newConnection()), SLOT(_server_newConnection()));
+		if(!_tcpServer->listen(host, port))
+		{
+			Log::error(QString("metrics: can't listen ") + address + ": " + _tcpServer->errorString());
+			return false;
+		}
+	}
+	LOG_INFO(Gui, QString("metrics: listen ") + address);
+	return true;
+}
+
+void MetricsServerClass::setMetrics(QByteArray metrics)
+{
+	_metrics = metrics;
+}
+
+void MetricsServerClass::appendHeader(QByteArray &out, const char *name, const char *type, const char *help)
+{
+	out += QByteArray("# HELP ") + name + ' ' + help + "\n# TYPE " + name + ' ' + type + '\n';
+}
+
+void MetricsServerClass::appendValue(QByteArray &out, const char *name, double value, const QByteArray &labels)
+{
+	out += name;
+	if(!labels.isEmpty())
+		out += '{' + labels + '}';
+	out += ' ';
+	if(qIsNaN(value))
+		out += "NaN";
+	else
+		out += QByteArray::number(value, 'g', 10);
+	out += '\n';
+}
+
+void MetricsServerClass::_server_newConnection()
+{
+	if(_tcpServer)
+		while(auto socket = _tcpServer->nextPendingConnection())
+			_accept(socket);
+	if(_localServer)
+		while(auto socket = _localServer->nextPendingConnection())
+			_accept(socket);
+}
+
+void MetricsServerClass::_accept(QIODevice *socket)
+{
+	connect(socket, SIGNAL(readyRead()), SLOT(_socket_readyRead()));
+	connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+}
+
+void MetricsServerClass::_socket_readyRead()
+{
+	auto socket = qobject_cast<QIODevice *>(sender());
+	if(!socket)
+		return;
+	auto header = socket->peek(REQUEST_MAX);
+	if(!header.contains("\r\n\r\n") && !header.contains("\n\n"))
+	{
+		if(header.length() >= REQUEST_MAX)
+			_close(socket);
+		return;
+	}
+	socket->readAll();
+
+	QByteArray reply;
+	if(header.startsWith("GET "))
+		reply = QByteArray("HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: ")
+			+ QByteArray::number(_metrics.length()) + "\r\nConnection: close\r\n\r\n" + _metrics;
+	else
+		reply = "HTTP/1.0 405 Method Not Allowed\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+	socket->write(reply);
+	_close(socket);
+}
+
+void MetricsServerClass::_close(QIODevice *socket)
+{
+	// pending data is written before disconnect
+	if(auto tcpSocket = qobject_cast<QTcpSocket *>(socket))
+		tcpSocket->disconnectFromHost();
+	else if(auto localSocket = qobject_cast<QLocalSocket *>(socket))
+		localSocket->disconnectFromServer();
+}
@@ -0,0 +1,48 @@
+#ifndef MetricsServerClass_H
+#define MetricsServerClass_H
+
+#include <QObject>
+#include <QByteArray>
+
+class QTcpServer;
+class QLocalServer;
+class QIODevice;
+
+//! Serves metrics in Prometheus text exposition format over HTTP
+//! Scrapes are answered from the cached metrics only
+class MetricsServerClass : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit MetricsServerClass(QObject *parent=NULL);
+
+	//! Starts to listen
+	//! @param address	"unix:<path>" - Unix socket; "[<host>:]<port>" - TCP port, default host is 127.0.0.1
+	bool listen(QString address);
+
+	//! Replaces the cached metrics
+	void setMetrics(QByteArray metrics);
+
+	//! Appends metric HELP & TYPE lines
+	static void appendHeader(QByteArray &out, const char *name, const char *type, const char *help);
+	//! Appends metric sample line
+	//! @param labels	Example: request="VOUT1Q"
+	static void appendValue(QByteArray &out, const char *name, double value, const QByteArray &labels = QByteArray());
+
+protected slots:
+	void _server_newConnection();
+	void _socket_readyRead();
+
+protected:
+	static constexpr int REQUEST_MAX = 8192; //!< HTTP request header size limit, bytes
+
+	QTcpServer *_tcpServer = nullptr;
+	QLocalServer *_localServer = nullptr;
+	QByteArray _metrics;
+
+	void _accept(QIODevice *socket);
+	void _close(QIODevice *socket);
+};
+
+#endif // MetricsServerClass_H
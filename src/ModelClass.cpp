@@ -0,0 +1,51 @@
+#include "ModelClass.h"
+
+constexpr unsigned ModelClass::SINGLE;
+constexpr unsigned ModelClass::DUAL;
+
+namespace _model
+{
+	//! Registry: clones share the model traits with own IDN token; KD models & clones firmware answers slower than KA
+	constexpr ModelClass MODELS[] =
+	{
+		// name, IDN token, channels, V, A, V decimals, A decimals, V answer, A answer, capabilities, interval
+		{ "KA3005P", "KA3005P", 1, 30, 5, 2, 3, 5, 5, ModelClass::SINGLE, 0 },
+		{ "KD3005P", "KD3005P", 1, 30, 5, 2, 3, 5, 5, ModelClass::SINGLE, 10 },
+		{ "KA3003P", "KA3003P", 1, 30, 3, 2, 3, 5, 5, ModelClass::SINGLE, 0 },
+		{ "KA6003P", "KA6003P", 1, 60, 3, 2, 3, 5, 5, ModelClass::SINGLE, 0 },
+		{ "KA6005P", "KA6005P", 1, 60, 5, 2, 3, 5, 5, ModelClass::SINGLE, 0 },
+		{ "KA3305P", "KA3305P", 2, 30, 5, 2, 3, 5, 5, ModelClass::DUAL, 20 },
+		// clones
+		{ "KA3005P", "72-2540", 1, 30, 5, 2, 3, 5, 5, ModelClass::SINGLE, 10 }, // Tenma
+		{ "KA3003P", "72-2535", 1, 30, 3, 2, 3, 5, 5, ModelClass::SINGLE, 10 }, // Tenma
+		{ "KA6003P", "72-2550", 1, 60, 3, 2, 3, 5, 5, ModelClass::SINGLE, 10 }, // Tenma
+		{ "KA3005P", "PS3005D", 1, 30, 5, 2, 3, 5, 5, ModelClass::SINGLE, 10 }, // Velleman
+	};
+
+	constexpr bool valid(const ModelClass *models, int count)
+	{
+		for(int i = 0; i < count; i++)
+			if(models[i].channels < 1 || models[i].channels > 2
+				|| models[i].voltageAnswerLength < 1 || models[i].voltageAnswerLength > 16
+				|| models[i].currentAnswerLength < 1 || models[i].currentAnswerLength > 16
+				|| (models[i].channels > 1) != models[i].supports(ModelClass::Tracking))
+				return false;
+		return true;
+	}
+
+	//! Not registered "KORAD" models: single channel with conservative timing
+	constexpr ModelClass GENERIC = { "KORAD", "KORAD", 1, 30, 5, 2, 3, 5, 5, ModelClass::SINGLE, 20 };
+
+	constexpr int MODELS_COUNT = sizeof(MODELS) / sizeof(MODELS[0]);
+	static_assert(valid(MODELS, MODELS_COUNT) && valid(&GENERIC, 1), "Model traits out of protocol limits");
+}
+
+const ModelClass *ModelClass::find(const QByteArray &idn)
+{
+	for(auto &model : _model::MODELS)
+		if(idn.contains(model.idn))
+			return &model;
+	if(idn.startsWith("KORAD"))
+		return &_model::GENERIC;
+	return nullptr;
+}
@@ -0,0 +1,43 @@
+#ifndef ModelClass_H
+#define ModelClass_H
+
+#include <QByteArray>
+
+//! PSU model capabilities, looked up by IDN answer
+//! The registry is a constexpr table (see ModelClass.cpp): traits are known at compile time & checked by static_assert
+class ModelClass
+{
+public:
+	//! Optional commands groups
+	enum CapabilityEnum : unsigned
+	{
+		Output = 1 << 0, //!< OUT0, OUT1
+		Protection = 1 << 1, //!< OVP0, OVP1, OCP0, OCP1
+		Memory = 1 << 2, //!< RCL, SAV
+		Tracking = 1 << 3, //!< TRACK: series & parallel modes of multichannel PSU
+		Status = 1 << 4, //!< STATUS?
+	};
+
+	const char *name; //!< Model, example: "KA3005P"
+	const char *idn; //!< IDN answer token identifying the model, example: "KA3005P"; "72-2540" for a clone
+	int channels; //!< Independent outputs count
+	float maxVoltage; //!< V
+	float maxCurrent; //!< A
+	int voltageDecimals; //!< Voltage readout decimals
+	int currentDecimals; //!< Current readout decimals
+	int voltageAnswerLength; //!< VSET?, VOUT? answer length, bytes, example: "05.00"
+	int currentAnswerLength; //!< ISET?, IOUT? answer length, bytes, example: "1.000"
+	unsigned capabilities; //!< CapabilityEnum mask
+	int requestInterval; //!< Safe interval between answer & the next request, ms: 0 - back to back
+
+	constexpr bool supports(CapabilityEnum capability) const { return capabilities & capability; }
+
+	//! @return Model of the IDN answer, example: "KORAD KA3005P V4.2 SN:########"
+	//! nullptr if the PSU isn't supported
+	static const ModelClass *find(const QByteArray &idn);
+
+	static constexpr unsigned SINGLE = Output | Protection | Memory | Status;
+	static constexpr unsigned DUAL = Output | Protection | Memory | Status | Tracking;
+};
+
+#endif // ModelClass_H
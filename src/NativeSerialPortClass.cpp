@@ -0,0 +1,260 @@
+#include <QSocketNotifier>
+#include <QFile>
+#include "NativeSerialPortClass.h"
+
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/ioctl.h>
+#include <linux/serial.h>
+#endif
+
+#ifdef Q_OS_LINUX
+namespace _native
+{
+	speed_t speed(int baud)
+	{
+		switch(baud)
+		{
+			case 1200: return B1200;
+			case 2400: return B2400;
+			case 4800: return B4800;
+			case 9600: return B9600;
+			case 19200: return B19200;
+			case 38400: return B38400;
+			case 57600: return B57600;
+			case 115200: return B115200;
+			case 230400: return B230400;
+			case 460800: return B460800;
+			case 921600: return B921600;
+			default: return B0;
+		}
+	}
+}
+#endif
+
+NativeSerialPortClass::NativeSerialPortClass(QObject *parent) :
+	TransportClass(parent)
+{
+}
+
+NativeSerialPortClass::~NativeSerialPortClass()
+{
+	close();
+}
+
+bool NativeSerialPortClass::open(QString portName)
+{
+	close();
+	_portName = portName;
+#ifdef Q_OS_LINUX
+	auto path = portName.contains('/') ? portName : QString("/dev/") + portName;
+	auto speed = _native::speed(_baud);
+	if(speed == B0 || _parity == QSerialPort::SpaceParity || _parity == QSerialPort::MarkParity
+		|| _stopBits == QSerialPort::OneAndHalfStop)
+	{
+		_error = EINVAL;
+		return false;
+	}
+	_fd = ::open(QFile::encodeName(path).constData(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+	if(_fd < 0)
+	{
+		_error = errno;
+		return false;
+	}
+
+	// exclusive like QSerialPort: other processes can't open the port
+	::ioctl(_fd, TIOCEXCL);
+
+	// raw mode: read() returns available bytes at once (VMIN = 0, VTIME = 0)
+	struct termios tio;
+	if(::tcgetattr(_fd, &tio))
+	{
+		_error = errno;
+		close();
+		return false;
+	}
+	::cfmakeraw(&tio);
+	tio.c_cflag |= CLOCAL | CREAD;
+	tio.c_cflag &= ~(CSIZE | PARENB | PARODD | CSTOPB | CRTSCTS);
+	switch(_dataBits)
+	{
+		case QSerialPort::Data5: tio.c_cflag |= CS5; break;
+		case QSerialPort::Data6: tio.c_cflag |= CS6; break;
+		case QSerialPort::Data7: tio.c_cflag |= CS7; break;
+		default: tio.c_cflag |= CS8; break;
+	}
+	if(_parity == QSerialPort::EvenParity)
+		tio.c_cflag |= PARENB;
+	else if(_parity == QSerialPort::OddParity)
+		tio.c_cflag |= PARENB | PARODD;
+	if(_stopBits == QSerialPort::TwoStop)
+		tio.c_cflag |= CSTOPB;
+	tio.c_cc[VMIN] = 0;
+	tio.c_cc[VTIME] = 0;
+	::cfsetispeed(&tio, speed);
+	::cfsetospeed(&tio, speed);
+	if(::tcsetattr(_fd, TCSANOW, &tio))
+	{
+		_error = errno;
+		close();
+		return false;
+	}
+
+	// FTDI & some CDC drivers: don't hold read bytes for latency timer; not supported by ptys
+	struct serial_struct serial;
+	_lowLatency = false;
+	if(!::ioctl(_fd, TIOCGSERIAL, &serial))
+	{
+		serial.flags |= ASYNC_LOW_LATENCY;
+		_lowLatency = !::ioctl(_fd, TIOCSSERIAL, &serial);
+	}
+
+	_error = 0;
+	_readNotifier = new QSocketNotifier(_fd, QSocketNotifier::Read, this);
+	connect(_readNotifier, SIGNAL(activated(int)), SLOT(_readNotifier_activated()));
+	_writeNotifier = new QSocketNotifier(_fd, QSocketNotifier::Write, this);
+	_writeNotifier->setEnabled(false);
+	connect(_writeNotifier, SIGNAL(activated(int)), SLOT(_writeNotifier_activated()));
+	return true;
+#else
+	_error = -1;
+	return false;
+#endif
+}
+
+void NativeSerialPortClass::close()
+{
+	// may be called from the notifier signal
+	if(_readNotifier)
+	{
+		_readNotifier->setEnabled(false);
+		_readNotifier->deleteLater();
+		_readNotifier = nullptr;
+	}
+	if(_writeNotifier)
+	{
+		_writeNotifier->setEnabled(false);
+		_writeNotifier->deleteLater();
+		_writeNotifier = nullptr;
+	}
+	_writePending.clear();
+#ifdef Q_OS_LINUX
+	if(_fd >= 0)
+		::close(_fd);
+#endif
+	_fd = -1;
+}
+
+QString NativeSerialPortClass::errorString() const
+{
+#ifdef Q_OS_LINUX
+	if(_error > 0)
+		return QString::fromLocal8Bit(::strerror(_error));
+#endif
+	return _error ? QString("not supported") : QString();
+}
+
+QString NativeSerialPortClass::description() const
+{
+	return serialParameters() + (_lowLatency ? " low latency" : "");
+}
+
+void NativeSerialPortClass::fail(int error)
+{
+	_error = error;
+	_readNotifier->setEnabled(false);
+	_writeNotifier->setEnabled(false);
+	emit errorOccurred(errorString());
+}
+
+void NativeSerialPortClass::_readNotifier_activated()
+{
+	emit readyRead();
+}
+
+qint64 NativeSerialPortClass::read(char *data, qint64 maxLength)
+{
+#ifdef Q_OS_LINUX
+	if(_fd < 0)
+		return -1;
+	for(;;)
+	{
+		auto length = ::read(_fd, data, maxLength);
+		if(length > 0)
+			return length;
+		if(length < 0 && errno == EINTR)
+			continue;
+		if(length < 0 && errno == EAGAIN)
+			return 0;
+		if(length < 0)
+		{
+			// EIO, ENXIO: hang up, example: device unplugged or pty master closed
+			fail(errno);
+			return -1;
+		}
+		// VMIN = VTIME = 0: no data right now returns 0 too; hang up is reported by poll()
+		pollfd fd = { _fd, POLLIN, 0 };
+		if(::poll(&fd, 1, 0) > 0 && (fd.revents & (POLLHUP | POLLERR | POLLNVAL)))
+		{
+			fail(EIO);
+			return -1;
+		}
+		return 0;
+	}
+#else
+	Q_UNUSED(data) Q_UNUSED(maxLength)
+	return -1;
+#endif
+}
+
+void NativeSerialPortClass::write(const QByteArray &data)
+{
+	if(_fd < 0)
+		return;
+	_writePending += data;
+	writePending();
+}
+
+void NativeSerialPortClass::writePending()
+{
+#ifdef Q_OS_LINUX
+	while(!_writePending.isEmpty())
+	{
+		auto length = ::write(_fd, _writePending.constData(), _writePending.length());
+		if(length > 0)
+			_writePending.remove(0, length);
+		else if(length < 0 && errno == EINTR)
+			continue;
+		else if(length < 0 && errno == EAGAIN)
+			break;
+		else
+		{
+			fail(errno);
+			return;
+		}
+	}
+	if(_writeNotifier)
+		_writeNotifier->setEnabled(!_writePending.isEmpty());
+#endif
+}
+
+void NativeSerialPortClass::_writeNotifier_activated()
+{
+	writePending();
+}
+
+void NativeSerialPortClass::clear()
+{
+#ifdef Q_OS_LINUX
+	if(_fd >= 0)
+		::tcflush(_fd, TCIOFLUSH);
+#endif
+	_writePending.clear();
+	if(_writeNotifier)
+		_writeNotifier->setEnabled(false);
+}
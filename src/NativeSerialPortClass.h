@@ -0,0 +1,60 @@
+#ifndef NativeSerialPortClass_H
+#define NativeSerialPortClass_H
+
+#include <QByteArray>
+#include "TransportClass.h"
+
+class QSocketNotifier;
+
+//! Linux serial port on raw file descriptor: termios raw mode, VMIN/VTIME = 0, ASYNC_LOW_LATENCY
+//! Read readiness is dispatched by the owner thread event loop; bytes are read directly to the caller buffer
+//! Also serves pseudo terminals (example: socat or ser2net pty), where low latency mode isn't supported
+class NativeSerialPortClass : public TransportClass
+{
+	Q_OBJECT
+
+public:
+	explicit NativeSerialPortClass(QObject *parent=NULL);
+	~NativeSerialPortClass();
+
+	TypeEnum type() const override { return TypeEnum::NativeSerial; }
+
+	//! @param portName	Example: ttyACM0; /dev/pts/3
+	bool open(QString portName) override;
+	void close() override;
+	bool isOpen() const override { return _fd >= 0; }
+
+	//! @return Last error: errno
+	int error() const { return _error; }
+	QString errorString() const override;
+	QString description() const override;
+	//! @return Whether driver low latency mode is set
+	bool isLowLatency() const { return _lowLatency; }
+
+	//! @return 0 - no data right now; -1 - port is failed (hang up), errorOccurred() is emitted
+	qint64 read(char *data, qint64 maxLength) override;
+
+	//! Writes data; data not accepted by driver is written when fd is writable
+	void write(const QByteArray &data) override;
+	//! Discards driver input & output buffers
+	void clear() override;
+
+protected slots:
+	void _readNotifier_activated();
+	void _writeNotifier_activated();
+
+protected:
+	int _fd = -1; //!< -1 - port closed
+	int _error = 0; //!< errno
+	bool _lowLatency = false;
+	QSocketNotifier *_readNotifier = nullptr;
+	QSocketNotifier *_writeNotifier = nullptr;
+	QByteArray _writePending; //!< Data not accepted by driver yet
+
+	//! Writes pending data
+	void writePending();
+	//! Stops notifications & emits error; the owner closes the port
+	void fail(int error);
+};
+
+#endif // NativeSerialPortClass_H
@@ -1,57 +1,274 @@
+#include <string.h>
+#include <math.h>
 #include <QSerialPortInfo>
 #include <QThread>
 #include <QCommandLineParser>
+#include <QMetaEnum>
+#include <QDateTime>
+#include <QFile>
 #include "Log.h"
+#include "Trace.h"
 #include "ProtocolClass.h"
 
+//! Request trace span IDs: unique across the devices, spans of the same name are matched by ID
+static std::atomic<quint64> _traceIds { 0 };
 
-bool _parseIdn(QByteArray answer)
+//! @return Model of the IDN answer with the wanted serial number; nullptr if not supported or another PSU
+const ModelClass *_parseIdn(QByteArray answer, QString serialNumber)
 {
 	// "KORAD KA3005P V4.2 SN:########", where # - digit
-	if(answer.startsWith("KORAD"))
+	auto model = ModelClass::find(answer);
+	if(model && (serialNumber.isEmpty() || answer.contains(QString("SN:%0").arg(serialNumber).toLatin1())))
+		return model;
+	return nullptr;
+}
+
+//! @return Whether the model supports the request
+static bool _supports(const ModelClass *model, ProtocolClass::RequestEnum r)
+{
+	switch(r)
 	{
-		if(answer.mid(5).trimmed().startsWith("KA3005P"))
-			return true;
+		case ProtocolClass::RequestEnum::STATUSQ: return model->supports(ModelClass::Status);
+		case ProtocolClass::RequestEnum::OUT0:
+		case ProtocolClass::RequestEnum::OUT1: return model->supports(ModelClass::Output);
+		case ProtocolClass::RequestEnum::OVP0:
+		case ProtocolClass::RequestEnum::OVP1:
+		case ProtocolClass::RequestEnum::OCP0:
+		case ProtocolClass::RequestEnum::OCP1: return model->supports(ModelClass::Protection);
+		case ProtocolClass::RequestEnum::RCL1:
+		case ProtocolClass::RequestEnum::SAV1: return model->supports(ModelClass::Memory);
+		case ProtocolClass::RequestEnum::TRACK0:
+		case ProtocolClass::RequestEnum::TRACK1:
+		case ProtocolClass::RequestEnum::TRACK2: return model->supports(ModelClass::Tracking);
+		case ProtocolClass::RequestEnum::VSET2Q:
+		case ProtocolClass::RequestEnum::VSET2:
+		case ProtocolClass::RequestEnum::VOUT2Q:
+		case ProtocolClass::RequestEnum::ISET2Q:
+		case ProtocolClass::RequestEnum::ISET2:
+		case ProtocolClass::RequestEnum::IOUT2Q: return model->channels >= 2;
+		default: return true;
 	}
-	return false;
 }
 
 ProtocolClass::ProtocolClass(QObject *parent) :
 	SerialPortClass({ VidPid(0x0416, 0x5011) }, parent)
 {
 	qRegisterMetaType<ProtocolClass::RequestEnum>();
+	// other USB-serial bridges share VID:PID: identify candidates concurrently
+	_probeRequest = "*IDN?";
+	_probeOpenDelay = DEFAULT_OPEN_PORT_DELAY;
+	_probeTimeout = DEFAULT_IDN_ANSWER_TIMEOUT;
+}
+
+void ProtocolClass::setSerialNumber(QString serialNumber)
+{
+	_serialNumber = serialNumber;
+}
+
+bool ProtocolClass::probeMatches(const QByteArray &answer) const
+{
+	return _parseIdn(answer, _serialNumber) != nullptr;
+}
+
+StatisticsClass ProtocolClass::statistics() const
+{
+	QMutexLocker locker(&_statisticsMutex);
+	return _statistics;
+}
+
+QString ProtocolClass::requestName(int r)
+{
+	return requestKey(r);
+}
+
+int ProtocolClass::channelOf(RequestEnum r)
+{
+	switch(r)
+	{
+		case RequestEnum::VSET2Q:
+		case RequestEnum::VSET2:
+		case RequestEnum::VOUT2Q:
+		case RequestEnum::ISET2Q:
+		case RequestEnum::ISET2:
+		case RequestEnum::IOUT2Q: return 1;
+		default: return 0;
+	}
+}
+
+const char *ProtocolClass::requestKey(int r)
+{
+	auto ret = QMetaEnum::fromType<RequestEnum>().valueToKey(r);
+	return ret ? ret : "?";
+}
+
+void ProtocolClass::setStatisticsFile(QString fileName, int interval)
+{
+	_statisticsFileName = fileName;
+	if(_statisticsTimerId >= 0)
+		killTimer(_statisticsTimerId);
+	_statisticsTimerId = interval > 0 ? startTimer(interval * 1000) : -1;
+}
+
+void ProtocolClass::dumpStatistics()
+{
+	auto text = statistics().toText(requestName);
+	// object name identifies the device if several are driven
+	auto name = objectName().isEmpty() ? QString() : QString(" ") + objectName();
+	Log::msg(QString("statistics%0:\n").arg(name) + text.trimmed());
+	if(!_statisticsFileName.isEmpty())
+	{
+		QFile file(_statisticsFileName);
+		if(file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+			file.write((QString("# %0%1\n").arg(QDateTime::currentDateTime().toString(Qt::ISODateWithMs)).arg(name)
+				+ text).toUtf8());
+		else
+			LOG_WARNING_RATE_LIMITED(Protocol, this, 60000, QString("can't write statistics ") + _statisticsFileName);
+	}
 }
 
 void ProtocolClass::clear()
 {
 	_request = RequestEnum::None;
 	_answerExpectedLen = 0;
-	_rxBuff.clear();
-	if(_serialPort && _serialPort->isOpen())
-		_serialPort->clear();
+	_rxLength = 0;
+	clearPort();
+	{
+		QMutexLocker locker(&_statisticsMutex);
+		_statistics.pendingRequests = 0;
+	}
 	if(_timerId >= 0)
 	{
 		killTimer(_timerId);
 		_timerId = -1;
 	}
+	if(_openTimerId >= 0)
+	{
+		killTimer(_openTimerId);
+		_openTimerId = -1;
+	}
+}
+
+//! Parses numeric answer in place, example: "05.00"
+//! @return false if answer isn't a number
+static bool _parseValue(const char *data, int length, float *value)
+{
+	// trailing line end or spaces
+	while(length > 0 && (data[length - 1] == '\n' || data[length - 1] == '\r' || data[length - 1] == ' '))
+		length--;
+	float ret = 0, scale = 0;
+	for(int i = 0; i < length; i++)
+	{
+		if(data[i] >= '0' && data[i] <= '9')
+		{
+			if(scale == 0)
+				ret = ret * 10 + (data[i] - '0');
+			else
+			{
+				ret += (data[i] - '0') * scale;
+				scale /= 10;
+			}
+		}
+		else if(data[i] == '.' && scale == 0)
+			scale = 0.1f;
+		else
+			return false;
+	}
+	*value = ret;
+	return length > 0;
 }
 
 void ProtocolClass::requestComplete()
 {
 	// answer RX complete
-	logData(_rxBuff);
+	logData(_rxBuff, _rxLength);
 
 	auto r = _request;
-	auto buff = _rxBuff;
+	auto length = _rxLength;
+	// numeric answers are decoded in place, others are copied since the buffer is reused by the next request
+	bool isValue = false, valueOk = false;
+	float value = NAN;
+	QByteArray buff;
+	switch(r)
+	{
+		case RequestEnum::VSET1Q:
+		case RequestEnum::VOUT1Q:
+		case RequestEnum::ISET1Q:
+		case RequestEnum::IOUT1Q:
+		case RequestEnum::VSET2Q:
+		case RequestEnum::VOUT2Q:
+		case RequestEnum::ISET2Q:
+		case RequestEnum::IOUT2Q:
+			isValue = true;
+			valueOk = _parseValue(_rxBuff, _rxLength, &value);
+			if(!valueOk)
+				value = NAN;
+			break;
+		default:
+			buff = QByteArray(_rxBuff, _rxLength);
+			break;
+	}
 	clear();
-	emit answer(r, buff);
+	// commands requested during the answer precede the next request
+	sendCommands();
+	if(Trace::enabled())
+		Trace::asyncEnd("protocol", requestKey((int)r), _traceId, QByteArray("\"bytes\":") + QByteArray::number(length));
+	{
+		QMutexLocker locker(&_statisticsMutex);
+		_statistics.answers++;
+		if(_resyncLevel != ResyncEnum::None && r != RequestEnum::IDN)
+		{
+			// timeout is resolved
+			if(_resyncLevel == ResyncEnum::Resend)
+				_statistics.resyncResends++;
+			else
+				_statistics.resyncPings++;
+			_resyncLevel = ResyncEnum::None;
+		}
+		if(length)
+			_statistics.latency[(int)r].record(_lastRxTime / 1000);
+		if(isValue && !valueOk)
+			_statistics.parseFailures++;
+	}
+	if(isValue)
+		emit answerValue(r, value);
+	else
+		emit answer(r, buff);
 
-	if(r == RequestEnum::IDN)
+	if(r == RequestEnum::IDN && _resyncLevel == ResyncEnum::Ping)
+	{
+		// PSU answers on the open port: resend the timed out request
+		auto pinged = _parseIdn(buff, _serialNumber);
+		if(pinged && pinged == model() && _resyncRequest != RequestEnum::None)
+			request(_resyncRequest);
+		else if(pinged && pinged == model())
+		{
+			// timeout is resolved
+			_resyncLevel = ResyncEnum::None;
+			{
+				QMutexLocker locker(&_statisticsMutex);
+				_statistics.resyncPings++;
+			}
+			resynced();
+		}
+		else
+			resync(r);
+	}
+	else if(r == RequestEnum::IDN)
 	{
 		// parse IDN answer for PSU model e.t.c.
-		_modelIsOk = _parseIdn(buff);
-		if(_modelIsOk)
+		auto model = _parseIdn(buff, _serialNumber);
+		_model.store(model);
+		if(!model)
+		{
+			QMutexLocker locker(&_statisticsMutex);
+			_statistics.parseFailures++;
+		}
+		if(model)
+		{
+			LOG_INFO(Protocol, QString("model %0: %1 channels, %2 V, %3 A").arg(model->name).arg(model->channels)
+				.arg(model->maxVoltage).arg(model->maxCurrent));
 			emit modelDetected(buff);
+		}
 		else
 			// unknown model or broken connection
 			closeSerialPortAndReconnect();
@@ -62,7 +279,7 @@ void ProtocolClass::timerEvent(QTimerEvent *event)
 {
 	if(_timerId == event->timerId())
 	{
-		if(_serialPort && _serialPort->isOpen())
+		if(isPortOpen())
 		{
 			if(_request == RequestEnum::IDN)
 				// since, IDN answer length is not known - use timeout to RX the answer
@@ -70,42 +287,122 @@ void ProtocolClass::timerEvent(QTimerEvent *event)
 			else
 			{
 				// request timeout detected
-				Log::msg("Timeout");
+				LOG_WARNING_RATE_LIMITED(Protocol, this, 1000, objectName() + ": Timeout");
+				if(Trace::enabled())
+					Trace::asyncEnd("protocol", requestKey((int)_request), _traceId, "\"timeout\":true");
+				{
+					QMutexLocker locker(&_statisticsMutex);
+					_statistics.timeouts++;
+				}
+				auto r = _request;
 				clear();
+				sendCommands();
 				emit answerTimeout();
-				closeSerialPortAndReconnect();
+				resync(r);
 			}
 		}
 		else
 			// serial port was closed
 			clear();
 	}
+	else if(_openTimerId == event->timerId())
+	{
+		killTimer(_openTimerId);
+		_openTimerId = -1;
+		request(RequestEnum::IDN);
+	}
+	else if(_statisticsTimerId == event->timerId())
+		dumpStatistics();
 	else
 		SerialPortClass::timerEvent(event);
 }
 
+void ProtocolClass::resync(RequestEnum r)
+{
+	switch(_resyncLevel)
+	{
+		case ResyncEnum::None:
+			if(r == RequestEnum::None)
+			{
+				// nothing to resend: the owner restarts after the ping
+				LOG_INFO(Protocol, "resync: IDN ping");
+				_resyncLevel = ResyncEnum::Ping;
+				_resyncRequest = r;
+				request(RequestEnum::IDN);
+				break;
+			}
+			// input is drained by clear()
+			LOG_INFO_ARGS(Protocol, "resync: resend %0", requestKey((int)r));
+			_resyncLevel = ResyncEnum::Resend;
+			_resyncRequest = r;
+			request(r);
+			break;
+		case ResyncEnum::Resend:
+			LOG_INFO(Protocol, "resync: IDN ping");
+			_resyncLevel = ResyncEnum::Ping;
+			request(RequestEnum::IDN);
+			break;
+		case ResyncEnum::Ping:
+			LOG_WARNING(Protocol, "resync: reconnect");
+			_resyncLevel = ResyncEnum::None;
+			{
+				QMutexLocker locker(&_statisticsMutex);
+				_statistics.resyncReconnects++;
+			}
+			closeSerialPortAndReconnect();
+			break;
+	}
+}
+
 void ProtocolClass::portOpened()
 {
-	_modelIsOk = false;
+	_model.store(nullptr);
+	_resyncLevel = ResyncEnum::None;
+	_commands.clear();
 	clear();
 
-	QThread::msleep(DEFAULT_OPEN_PORT_DELAY);
-	request(RequestEnum::IDN);
+	if(!_probeAnswer.isEmpty())
+	{
+		// port is identified by probe
+		_model.store(_parseIdn(_probeAnswer, _serialNumber));
+		emit modelDetected(_probeAnswer);
+		return;
+	}
+	if(isReplay())
+	{
+		request(RequestEnum::IDN);
+		return;
+	}
+	// the PSU ignores requests right after open; the I/O thread keeps serving other devices
+	_openTimerId = startTimer(DEFAULT_OPEN_PORT_DELAY);
 }
 
 void ProtocolClass::portClosed()
 {
-	_modelIsOk = false;
+	_model.store(nullptr);
+	_resyncLevel = ResyncEnum::None;
+	_commands.clear();
 	clear();
+	QMutexLocker locker(&_statisticsMutex);
+	_statistics.reconnects++;
 }
 
-void ProtocolClass::dataArrived(QByteArray data)
+void ProtocolClass::dataArrived(const char *data, int length)
 {
-	_rxBuff += data;
+	TRACE_SCOPE("protocol", "dataArrived");
+	_lastRxTime = _requestTimer.nsecsElapsed();
+	{
+		QMutexLocker locker(&_statisticsMutex);
+		_statistics.bytesIn += length;
+	}
+	// bytes above the longest answer are dropped
+	auto copied = qMin(length, RX_BUFFER_SIZE - _rxLength);
+	memcpy(_rxBuff + _rxLength, data, copied);
+	_rxLength += copied;
 
 	// check RX buffer for expected answer
 	if(_request != RequestEnum::IDN)
-		if(_rxBuff.length() >= _answerExpectedLen)
+		if(_rxLength >= _answerExpectedLen)
 			// answer RX complete
 			requestComplete();
 }
@@ -117,20 +414,60 @@ void ProtocolClass::request(RequestEnum r)
 
 void ProtocolClass::request(RequestEnum r, float value)
 {
-	if(!_modelIsOk && r != RequestEnum::IDN)
+	auto model = this->model();
+	if(!model && r != RequestEnum::IDN)
+	{
+		QMutexLocker locker(&_statisticsMutex);
+		_statistics.droppedRequests++;
+		return;
+	}
+	if(model && !_supports(model, r))
+	{
+		QMutexLocker locker(&_statisticsMutex);
+		_statistics.unsupportedRequests++;
 		return;
+	}
 
-	if(_request == RequestEnum::None || r != _request)
+	if(_request != RequestEnum::None && r == _request)
+	{
+		QMutexLocker locker(&_statisticsMutex);
+		_statistics.duplicateRequests++;
+	}
+	else
 	{
 		switch(r)
 		{
 			case RequestEnum::IDN: sendRequest("*IDN?", r, 1024); break;
 			case RequestEnum::STATUSQ: sendRequest("STATUS?", r, 1); break;
-			case RequestEnum::VSET1Q: sendRequest("VSET1?", r, 5); break;
-			case RequestEnum::VSET1: sendRequest(QString("VSET1:%0").arg(value).toLatin1(), r); break;
-			case RequestEnum::VOUT1Q: sendRequest("VOUT1?", r, 5); break;
-			case RequestEnum::ISET1Q: sendRequest("ISET1?", r, 5); break;
-			case RequestEnum::IOUT1Q: sendRequest("IOUT1?", r, 5); break;
+			case RequestEnum::VSET1Q: sendRequest("VSET1?", r, model->voltageAnswerLength); break;
+			case RequestEnum::VSET2Q: sendRequest("VSET2?", r, model->voltageAnswerLength); break;
+			case RequestEnum::VSET1:
+			case RequestEnum::VSET2:
+				sendRequest(QString("VSET%0:%1").arg(channelOf(r) + 1)
+					.arg(qBound(0.f, value, model->maxVoltage), 0, 'f', model->voltageDecimals).toLatin1(), r);
+				break;
+			case RequestEnum::VOUT1Q: sendRequest("VOUT1?", r, model->voltageAnswerLength); break;
+			case RequestEnum::VOUT2Q: sendRequest("VOUT2?", r, model->voltageAnswerLength); break;
+			case RequestEnum::ISET1Q: sendRequest("ISET1?", r, model->currentAnswerLength); break;
+			case RequestEnum::ISET2Q: sendRequest("ISET2?", r, model->currentAnswerLength); break;
+			case RequestEnum::ISET1:
+			case RequestEnum::ISET2:
+				sendRequest(QString("ISET%0:%1").arg(channelOf(r) + 1)
+					.arg(qBound(0.f, value, model->maxCurrent), 0, 'f', model->currentDecimals).toLatin1(), r);
+				break;
+			case RequestEnum::IOUT1Q: sendRequest("IOUT1?", r, model->currentAnswerLength); break;
+			case RequestEnum::IOUT2Q: sendRequest("IOUT2?", r, model->currentAnswerLength); break;
+			case RequestEnum::OUT0: sendRequest("OUT0", r); break;
+			case RequestEnum::OUT1: sendRequest("OUT1", r); break;
+			case RequestEnum::OVP0: sendRequest("OVP0", r); break;
+			case RequestEnum::OVP1: sendRequest("OVP1", r); break;
+			case RequestEnum::OCP0: sendRequest("OCP0", r); break;
+			case RequestEnum::OCP1: sendRequest("OCP1", r); break;
+			case RequestEnum::RCL1: sendRequest(QString("RCL%0").arg(qBound(1, (int)value, 5)).toLatin1(), r); break;
+			case RequestEnum::SAV1: sendRequest(QString("SAV%0").arg(qBound(1, (int)value, 5)).toLatin1(), r); break;
+			case RequestEnum::TRACK0: sendRequest("TRACK0", r); break;
+			case RequestEnum::TRACK1: sendRequest("TRACK1", r); break;
+			case RequestEnum::TRACK2: sendRequest("TRACK2", r); break;
 			default:
 				return;
 		}
@@ -139,53 +476,76 @@ void ProtocolClass::request(RequestEnum r, float value)
 
 void ProtocolClass::sendRequest(QByteArray data, RequestEnum r, int answerExpectedLen)
 {
-	if(_serialPort && _serialPort->isOpen())
+	if(!answerExpectedLen && _request != RequestEnum::None)
+	{
+		// the answer in flight isn't discarded
+		_commands.append(qMakePair(data, r));
+		return;
+	}
+	if(isPortOpen())
 	{
 		logData(data, true);
+		{
+			QMutexLocker locker(&_statisticsMutex);
+			_statistics.requests++;
+			_statistics.bytesOut += data.length();
+			_statistics.pendingRequests = answerExpectedLen > 0 ? 1 : 0;
+		}
 		// flush serial port data
-		if(_serialPort && _serialPort->isOpen())
-			_serialPort->flush();
-		_rxBuff.clear();
+		flushPort();
+		_rxLength = 0;
 		// send request
 		if(answerExpectedLen > 0)
 		{
 			// send request & wait for answer with timeout
 			_request = r;
 			_answerExpectedLen = answerExpectedLen;
-			if(_serialPort && _serialPort->isOpen())
-			{
-				_serialPort->clear();
-				_serialPort->write(data);
-			}
+			clearPort();
+			writePort(data);
+			_traceId = _traceIds.fetch_add(1, std::memory_order_relaxed) + 1;
+			Trace::asyncBegin("protocol", requestKey((int)r), _traceId);
+			_requestTimer.start();
+			_requestTimestamp = Log::timestamp();
+			_lastRxTime = 0;
 			// wait for answer with timeout
 			if(_timerId >= 0)
 				killTimer(_timerId);
 //			Log::msg(QString("T %0:%1").arg(__LINE__).arg(__FILE__));
-			_timerId = startTimer(r == RequestEnum::IDN ? DEFAULT_IDN_ANSWER_TIMEOUT : DEFAULT_ANSWER_TIMEOUT);
+			// answer timeout is extended by the transport round trip, example: TCP
+			_timerId = startTimer((r == RequestEnum::IDN ? DEFAULT_IDN_ANSWER_TIMEOUT : DEFAULT_ANSWER_TIMEOUT)
+				+ latencyBudget());
 		}
 		else
 		{
 			// send request
 			_request = RequestEnum::None;
 			_answerExpectedLen = 0;
-			if(_serialPort && _serialPort->isOpen())
-			{
-				_serialPort->clear();
-				_serialPort->write(data);
-			}
+			clearPort();
+			writePort(data);
+			Trace::instant("protocol", requestKey((int)r));
 			// ready for next request
 			emit answer(r, QByteArray());
 		}
 	}
 	else
 	{
-		Log::msg("Try write to closed port");
+		LOG_WARNING_RATE_LIMITED(Protocol, this, 1000, "Try write to closed port");
+	}
+}
+
+void ProtocolClass::sendCommands()
+{
+	while(!_commands.isEmpty() && _request == RequestEnum::None)
+	{
+		auto command = _commands.takeFirst();
+		sendRequest(command.first, command.second);
 	}
 }
 
 void ProtocolClass::stop()
 {
 	// stop protocol
+	_commands.clear();
 	clear();
 	// stop serial port
 	closeSerialPort(false);
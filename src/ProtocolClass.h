@@ -1,10 +1,16 @@
 #ifndef ProtocolClass_H
 #define ProtocolClass_H
 
+#include <atomic>
 #include <QByteArray>
 #include <QVector>
+#include <QPair>
 #include <QThread>
+#include <QMutex>
+#include <QElapsedTimer>
 #include "SerialPortClass.h"
+#include "StatisticsClass.h"
+#include "ModelClass.h"
 
 class ProtocolClass : public SerialPortClass
 {
@@ -26,6 +32,13 @@ public:
 		ISET1, //!< Set the maximum output current
 		IOUT1Q, //!< Request the actual output current
 
+		VSET2Q, //!< Request the channel 2 voltage as set by the user
+		VSET2, //!< Set the channel 2 maximum output voltage
+		VOUT2Q, //!< Request the channel 2 actual voltage output
+		ISET2Q, //!< Request the channel 2 current as set by the user
+		ISET2, //!< Set the channel 2 maximum output current
+		IOUT2Q, //!< Request the channel 2 actual output current
+
 		OUT0, //!< Disable the power output
 		OUT1, //!< Enable the power output
 		OVP0, //!< Disable the "Over Voltage Protection"
@@ -33,15 +46,46 @@ public:
 		OCP0, //!< Disable the "Over Current Protection"
 		OCP1, //!< Enable the "Over Current Protection"
 
-		RCL1, //!< Recalls voltage and current limits from memory: 1..5
-		SAV1, //!< Saves voltage and current limits to memory: 1..5
+		RCL1, //!< Recalls voltage and current limits from memory: the request value 1..5
+		SAV1, //!< Saves voltage and current limits to memory: the request value 1..5
 
-		TRACK0, //!< Set multichannel mode, 0 independent, 1 series, 2 parallel
+		TRACK0, //!< Set multichannel mode: independent
+		TRACK1, //!< Set multichannel mode: series
+		TRACK2, //!< Set multichannel mode: parallel
 	};
 	Q_ENUM(RequestEnum)
 
+	//! Answer timeout recovery level
+	enum class ResyncEnum
+	{
+		None,
+		Resend, //!< Input drained & request resent
+		Ping, //!< IDN ping on the open port, then request resent
+	};
+
 	explicit ProtocolClass(QObject *parent=NULL);
 
+	//! @return Statistics snapshot; thread-safe
+	StatisticsClass statistics() const;
+
+	//! @return Request name, example: "VOUT1Q"
+	static QString requestName(int r);
+	//! @return Request name with static storage, example: "VOUT1Q"
+	static const char *requestKey(int r);
+	//! @return Output channel of the request: 0 - channel 1 or not a channel request; 1 - channel 2
+	static int channelOf(RequestEnum r);
+
+	//! Starts to append statistics to file periodically
+	//! @param interval	s
+	void setStatisticsFile(QString fileName, int interval);
+
+	//! @return Detected PSU model: nullptr - not detected; thread-safe
+	const ModelClass *model() const { return _model.load(); }
+
+	//! Connects to the PSU with the serial number only
+	//! @param serialNumber	Example: "00012345"; empty - any
+	void setSerialNumber(QString serialNumber);
+
 public slots:
 	void request(ProtocolClass::RequestEnum r);
 	void request(ProtocolClass::RequestEnum r, float value);
@@ -49,8 +93,15 @@ public slots:
 	//! Stops & cleanups the protocol state & timers
 	void stop();
 
+	//! Writes statistics to log & statistics file
+	void dumpStatistics();
+
 signals:
+	//! Answer of not numeric request: IDN, STATUS? & requests without answer
 	void answer(ProtocolClass::RequestEnum request, QByteArray value);
+	//! Numeric answer decoded in place: VSETn?, ISETn?, VOUTn?, IOUTn?
+	//! @param value	NAN if answer can't be parsed
+	void answerValue(ProtocolClass::RequestEnum request, float value);
 	void answerTimeout();
 
 	//! IDN answer
@@ -62,21 +113,49 @@ protected:
 	static constexpr int DEFAULT_ANSWER_TIMEOUT = 150; //!< Answer timeout, ms
 	static constexpr int DEFAULT_OPEN_PORT_DELAY = 500; //!< Delay after port opened, ms
 
-	bool _modelIsOk = false; //!< IDN answer parsing result
+	std::atomic<const ModelClass *> _model { nullptr }; //!< IDN answer parsing result
+	QString _serialNumber; //!< Wanted PSU serial number: empty - any
+	ResyncEnum _resyncLevel = ResyncEnum::None; //!< Answer timeout recovery level
+	RequestEnum _resyncRequest = RequestEnum::None; //!< Timed out request to resend: None - the owner restarts by resynced()
 
 	RequestEnum _request = RequestEnum::None; //!< Request
-	QByteArray _rxBuff; //!< Answer buffer
+	static constexpr int RX_BUFFER_SIZE = 64; //!< The longest answer (IDN), bytes
+
+	char _rxBuff[RX_BUFFER_SIZE]; //!< Answer buffer
+	int _rxLength = 0; //!< Answer length, bytes: 0..RX_BUFFER_SIZE
 	int _timerId = -1; //!< Answer timeout timer ID: -1 - timer not launched; 0..
+	int _openTimerId = -1; //!< Delay after port opened timer ID: -1 - timer not launched; 0..
 	int _answerExpectedLen = 0; //!< Answer expected length, bytes: 0..
+	QVector<QPair<QByteArray, RequestEnum> > _commands; //!< Requests without answer, waiting for the pending answer
+
+	mutable QMutex _statisticsMutex; //!< Protects statistics
+	StatisticsClass _statistics;
+	QElapsedTimer _requestTimer; //!< Since request sent
+	quint64 _requestTimestamp = 0; //!< Request sent, Log::timestamp(), ns
+	qint64 _lastRxTime = 0; //!< Last answer bytes arrival since request sent, ns
+	QString _statisticsFileName;
+	int _statisticsTimerId = -1; //!< Statistics file write timer ID: -1 - timer not launched; 0..
+	quint64 _traceId = 0; //!< Last request trace span ID: unique in the process
 
 	void timerEvent(QTimerEvent *event) override;
 
 	void portOpened() override;
 	void portClosed() override;
 
-	void dataArrived(QByteArray data) override;
+	void dataArrived(const char *data, int length) override;
+
+	bool probeMatches(const QByteArray &answer) const override;
 
+	//! Request without answer is queued while an answer is pending: sent right after the answer or its timeout
 	void sendRequest(QByteArray data, RequestEnum r, int answerExpectedLen=0);
+	//! Sends the queued requests without answer
+	void sendCommands();
+
+	//! Escalates answer timeout recovery: resend, IDN ping, then full reconnect
+	//! @param r	Timed out request: None - nothing to resend, the PSU is pinged
+	void resync(RequestEnum r);
+	//! The PSU answered the ping after a timeout without request to resend: the owner restarts its requests
+	virtual void resynced() {}
 
 	//! Completes answer recieving
 	virtual void requestComplete();
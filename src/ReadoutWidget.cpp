@@ -0,0 +1,156 @@
+#include <QPainter>
+#include <QPaintEvent>
+#include <QFontMetrics>
+#include "ReadoutWidget.h"
+
+ReadoutWidget::ReadoutWidget(QWidget *parent) :
+	QWidget(parent)
+{
+	updateMetrics();
+}
+
+void ReadoutWidget::setLength(int length)
+{
+	if(length > 0 && length != _length)
+	{
+		_length = length;
+		updateGeometry();
+	}
+}
+
+QSize ReadoutWidget::sizeHint() const
+{
+	// reserved for the longest text with decimal point, so the layout not depends on text
+	return QSize(_length * _cellWidth + _pointWidth, _cellHeight);
+}
+
+QSize ReadoutWidget::minimumSizeHint() const
+{
+	return sizeHint();
+}
+
+void ReadoutWidget::setText(const QString &text)
+{
+	if(text == _text)
+		return;
+
+	auto cellX = cellsX(text);
+	if(cellX != _cellX)
+		// characters moved, example: decimal point position changed
+		update();
+	else
+	{
+		// repaint changed characters only
+		int y = (height() - _cellHeight) / 2;
+		for(int i = 0; i < text.length(); i++)
+			if(text[i] != _text[i])
+				update(QRect(cellX[i], y, cellWidth(text[i]), _cellHeight));
+	}
+	_text = text;
+	_cellX = cellX;
+}
+
+void ReadoutWidget::paintEvent(QPaintEvent *event)
+{
+	// the font is resolved at paint time, like QLabel does: application fonts may be added after the font is set
+	if(_atlas.isNull() || _atlas.devicePixelRatio() != devicePixelRatioF())
+		updateAtlas();
+	QPainter painter(this);
+	int y = (height() - _cellHeight) / 2;
+	for(int i = 0; i < _text.length(); i++)
+	{
+		QRect cell(_cellX[i], y, cellWidth(_text[i]), _cellHeight);
+		if(event->rect().intersects(cell))
+			painter.drawPixmap(QRectF(cell), _atlas, glyphRect(_text[i]));
+	}
+}
+
+void ReadoutWidget::changeEvent(QEvent *event)
+{
+	switch(event->type())
+	{
+		case QEvent::FontChange:
+		case QEvent::PaletteChange:
+		case QEvent::StyleChange:
+			updateMetrics();
+			_atlas = QPixmap();
+			_cellX = cellsX(_text);
+			updateGeometry();
+			update();
+			break;
+		default: break;
+	}
+	QWidget::changeEvent(event);
+}
+
+bool ReadoutWidget::event(QEvent *event)
+{
+	// moved to a screen: device pixel ratio may differ
+	if(event->type() == QEvent::ScreenChangeInternal)
+	{
+		_atlas = QPixmap();
+		update();
+	}
+	return QWidget::event(event);
+}
+
+void ReadoutWidget::updateMetrics()
+{
+	QFontMetrics fm(font());
+	auto advance = [&fm](QChar ch) {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 11, 0)
+		return fm.horizontalAdvance(ch);
+#else
+		return fm.width(ch);
+#endif
+	};
+	QString glyphs(GLYPHS);
+
+	// glyph sizes
+	_cellWidth = 0;
+	foreach(auto ch, glyphs)
+		if(ch != '.')
+			_cellWidth = qMax(_cellWidth, advance(ch));
+	_pointWidth = advance('.');
+	_cellHeight = fm.height();
+}
+
+void ReadoutWidget::updateAtlas()
+{
+	// render glyphs
+	QString glyphs(GLYPHS);
+	auto ratio = devicePixelRatioF();
+	_atlas = QPixmap(QSize(glyphs.length() * _cellWidth, _cellHeight) * ratio);
+	_atlas.setDevicePixelRatio(ratio);
+	_atlas.fill(Qt::transparent);
+	QPainter painter(&_atlas);
+	painter.setFont(font());
+	painter.setPen(palette().color(foregroundRole()));
+	for(int i = 0; i < glyphs.length(); i++)
+		painter.drawText(QRect(i * _cellWidth, 0, cellWidth(glyphs[i]), _cellHeight), Qt::AlignCenter, glyphs[i]);
+}
+
+QVector<int> ReadoutWidget::cellsX(const QString &text) const
+{
+	// left positions of characters & the right position of the text
+	QVector<int> ret;
+	ret.reserve(text.length() + 1);
+	int x = 0;
+	foreach(auto ch, text)
+	{
+		ret.append(x);
+		x += cellWidth(ch);
+	}
+	ret.append(x);
+	return ret;
+}
+
+QRectF ReadoutWidget::glyphRect(QChar ch) const
+{
+	auto i = QString(GLYPHS).indexOf(ch);
+	if(i < 0)
+		// unknown character: space
+		i = QString(GLYPHS).indexOf(' ');
+	auto ratio = _atlas.devicePixelRatio();
+	return QRectF(i * _cellWidth * ratio, 0, cellWidth(ch) * ratio, _cellHeight * ratio);
+}
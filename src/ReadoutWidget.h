@@ -0,0 +1,65 @@
+#ifndef ReadoutWidget_H
+#define ReadoutWidget_H
+
+#include <QWidget>
+#include <QPixmap>
+#include <QVector>
+#include <QString>
+
+//! Numeric readout, like a QLabel for text as "12.34" or "--.--"
+//! Glyphs are pre-rendered to the atlas by widget font & foreground color on the first paint after a change,
+//! setText() repaints only changed characters and never invalidates the layout
+class ReadoutWidget : public QWidget
+{
+	Q_OBJECT
+	Q_PROPERTY(QString text READ text WRITE setText)
+	Q_PROPERTY(int length READ length WRITE setLength)
+
+public:
+	explicit ReadoutWidget(QWidget *parent=NULL);
+
+	QString text() const { return _text; }
+	int length() const { return _length; }
+
+	//! Sets readout characters count to reserve the widget size for; decimal point is not counted
+	void setLength(int length);
+
+	QSize sizeHint() const override;
+	QSize minimumSizeHint() const override;
+
+public slots:
+	void setText(const QString &text);
+
+protected:
+	static constexpr int DEFAULT_LENGTH = 4; //!< Characters count, example: "12.34"
+	static constexpr const char *GLYPHS = "0123456789-. "; //!< Characters of the atlas, other characters are drawn as space
+
+	int _length = DEFAULT_LENGTH;
+	QString _text; //!< Current text
+	QVector<int> _cellX; //!< Current text characters left position, px
+
+	QPixmap _atlas; //!< Pre-rendered glyphs, one cell per GLYPHS character: null - rendered by the next paint
+	int _cellWidth = 0; //!< Digit glyph width, px
+	int _pointWidth = 0; //!< Decimal point glyph width, px
+	int _cellHeight = 0; //!< Glyph height, px
+
+	void paintEvent(QPaintEvent *event) override;
+	void changeEvent(QEvent *event) override;
+	bool event(QEvent *event) override;
+
+	//! Updates glyph sizes for current font
+	void updateMetrics();
+	//! Renders glyphs to the atlas for current font, foreground color & device pixel ratio
+	void updateAtlas();
+
+	//! @return Characters left positions for the text, px
+	QVector<int> cellsX(const QString &text) const;
+
+	//! @return Character width, px
+	int cellWidth(QChar ch) const { return ch == '.' ? _pointWidth : _cellWidth; }
+
+	//! @return Atlas source rectangle of the character glyph, device px
+	QRectF glyphRect(QChar ch) const;
+};
+
+#endif // ReadoutWidget_H
@@ -2,77 +2,27 @@
 #include <math.h>
 #include <QSerialPortInfo>
 #include <QVector>
+#include <QHash>
 #include <QStringRef>
 #include <QCommandLineParser>
+#include <QFileInfo>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentRun>
 #include "Log.h"
+#include "Trace.h"
 #include "SerialPortClass.h"
 
 static constexpr int COM_PORT_FIND_START_INTERVAL = 1000; //!< Find inverval for low reconnect delay, ms
 static constexpr int COM_PORT_FIND_START_ATTEMPTS = 5; //!< Attempts count for low reconnect delay
 static constexpr int COM_PORT_FIND_INTERVAL = 1500; //!< ms
+static constexpr int COM_PORT_FIND_HOTPLUG_INTERVAL = 10000; //!< Fallback find interval while hotplug monitor is active, ms
 
-static QString _toEscapedCString(QByteArray buff)
-{
-	QString ret;
-	foreach(auto ch, buff) {
-		switch(ch)
-		{
-			case 0: ret += "\\0"; break;
-			case 7: ret += "\\a"; break;
-			case 8: ret += "\\b"; break;
-			case 9: ret += "\\t"; break;
-			case 0xa: ret += "\\n"; break;
-			case 0xb: ret += "\\v"; break;
-			case 0xc: ret += "\\f"; break;
-			case 0xd: ret += "\\r"; break;
-			default:
-				if(ch < 0x20 || (uint8_t)ch > 0x7E)
-				{
-					QByteArray a(&ch, 1);
-					ret += QString("\\x") + a.toHex().toUpper();
-				}
-				else
-					ret += ch;
-			break;
-		}
-	}
-	return ret;
-}
+QMutex SerialPortClass::_claimedMutex;
+QSet<QString> SerialPortClass::_claimedPorts;
 
 namespace _port
 {
-	inline QLatin1Char parity(QSerialPort *port)
-	{
-		switch(port->parity())
-		{
-			case QSerialPort::NoParity: return QLatin1Char('N');
-			case QSerialPort::EvenParity: return QLatin1Char('E');
-			case QSerialPort::OddParity: return QLatin1Char('O');
-			case QSerialPort::SpaceParity: return QLatin1Char('S');
-			case QSerialPort::MarkParity: return QLatin1Char('M');
-			default: return QLatin1Char(' ');
-		}
-	}
-
-	inline QString stopBits(QSerialPort *port)
-	{
-		switch(port->stopBits())
-		{
-			case QSerialPort::OneStop: return "1";
-			case QSerialPort::OneAndHalfStop: return "1.5";
-			case QSerialPort::TwoStop: return "2";
-			default: return " ";
-		}
-	}
-
-	inline QString parameters(QSerialPort *port)
-	{
-		auto ret = QString("%1 %2%3%4")
-			.arg(port->baudRate())
-			.arg(port->dataBits()).arg(parity(port)).arg(stopBits(port));
-		return ret;
-	}
-
 	bool set_parameters(QString parameters,
 		QSerialPort::DataBits *_dataBits,
 		QSerialPort::Parity *_parity,
@@ -123,16 +73,74 @@ namespace _port
 
 		return true;
 	}
+
+	//! Opens port, writes request & reads answer until timeout; runs concurrently for candidate ports in the probe pool
+	//! @param capture	Timestamps source of the exchange records, if the capture is started
+	SerialPortClass::ProbeResult probe(QString portName, int baud, QSerialPort::DataBits dataBits, QSerialPort::Parity parity,
+		QSerialPort::StopBits stopBits, QByteArray request, int openDelay, int timeout, const WireTraceClass *capture)
+	{
+		SerialPortClass::ProbeResult ret;
+		auto record = [&](WireTraceClass::DirectionEnum direction, const QByteArray &data) {
+			if(capture->isWriting())
+				ret.exchange.append({ capture->timestamp(), direction, data });
+		};
+		QSerialPort port(portName);
+		port.setBaudRate(baud);
+		port.setDataBits(dataBits);
+		port.setParity(parity);
+		port.setStopBits(stopBits);
+		if(!port.open(QIODevice::ReadWrite))
+			return ret;
+		QThread::msleep(openDelay);
+		port.clear();
+		record(WireTraceClass::DirectionEnum::ProbeTX, request);
+		port.write(request);
+		if(!port.waitForBytesWritten(timeout))
+			return ret;
+		while(port.waitForReadyRead(timeout))
+		{
+			auto data = port.readAll();
+			record(WireTraceClass::DirectionEnum::ProbeRX, data);
+			ret.answer += data;
+		}
+		return ret;
+	}
+}
+
+void SerialPortClass::setNativeBackend(bool native)
+{
+	_nativeBackend = native;
+}
+
+void SerialPortClass::setPortName(QString portName)
+{
+	_portName = portName;
+	_vidPid.clear();
 }
 
 SerialPortClass::SerialPortClass(QVector<VidPid> vidPid, QObject *parent)
 	: QObject(parent), _vidPid(vidPid)
 {
 	// start reconnect timer // start to search port in the system by timer
-	Log::msg(QString("T %0:%1").arg(__LINE__).arg(__FILE__));
+	LOG_DEBUG(Serial, QString("T %0:%1").arg(__LINE__).arg(__FILE__));
 	_reconnectTimerId = startTimer(0);
 }
 
+bool SerialPortClass::setCapture(QString fileName)
+{
+	return _capture.openWrite(fileName);
+}
+
+bool SerialPortClass::setReplay(QString fileName, bool realTime)
+{
+	_replayRealTime = realTime;
+	_replayPos = 0;
+	if(!_replayTrace.read(fileName))
+		return false;
+	_portName = QString("replay:") + fileName;
+	return true;
+}
+
 void SerialPortClass::processReconnectTimer()
 {
 	// com port not found
@@ -140,9 +148,16 @@ void SerialPortClass::processReconnectTimer()
 	switch(_reconnectAttemptsCount)
 	{
 		case 0:
+			killTimer(_reconnectTimerId);
+			if(_hotplug && _hotplug->isActive())
+			{
+				// port appearance is signalled by hotplug monitor: find rarely as fallback
+				_reconnectAttemptsCount = COM_PORT_FIND_START_ATTEMPTS + 1;
+				_reconnectTimerId = startTimer(COM_PORT_FIND_HOTPLUG_INTERVAL);
+				break;
+			}
 			// start reconnect timer with high rate
 			_reconnectAttemptsCount = 1;
-			killTimer(_reconnectTimerId);
 			_reconnectTimerId = startTimer(COM_PORT_FIND_START_INTERVAL);
 			break;
 		case COM_PORT_FIND_START_ATTEMPTS:
@@ -162,19 +177,32 @@ void SerialPortClass::processReconnectTimer()
 
 void SerialPortClass::timerEvent(QTimerEvent *event)
 {
-	if(event->timerId() == _reconnectTimerId)
+	if(event->timerId() == _replayTimerId)
+		processReplayTimer();
+	else if(event->timerId() == _reconnectTimerId && isReplay())
 	{
+		// replay is opened at once or is complete
+		killTimer(_reconnectTimerId);
+		_reconnectTimerId = -1;
+		openReplay();
+	}
+	else if(event->timerId() == _reconnectTimerId)
+	{
+		TRACE_SCOPE("serial", "find port");
+		if(!_hotplug)
+			startHotplug();
+		if(!_probes.isEmpty() || !_opening.first.isEmpty())
+		{
+			// completed by _probe_finished() or _transport_opened()
+			processReconnectTimer();
+			return;
+		}
 		auto portAndVidPid = tryFindComPort();
 		if(!portAndVidPid.first.isEmpty())
 		{
 			// com port found
 			if(openSerialPort(portAndVidPid))
-			{
-				// stop reconnect timer
-				killTimer(_reconnectTimerId);
-				_reconnectTimerId = -1;
-				_reconnectAttemptsCount = 0;
-			}
+				stopReconnectTimer();
 			else
 				processReconnectTimer();
 		}
@@ -184,102 +212,288 @@ void SerialPortClass::timerEvent(QTimerEvent *event)
 	else
 	{
 		killTimer(event->timerId());
-		Log::msg("Timer not procced.");
+		LOG_WARNING(Serial, "Timer not procced.");
 	}
 }
 
+void SerialPortClass::stopReconnectTimer()
+{
+	if(_reconnectTimerId >= 0)
+		killTimer(_reconnectTimerId);
+	_reconnectTimerId = -1;
+	_reconnectAttemptsCount = 0;
+}
+
+void SerialPortClass::startHotplug()
+{
+	_hotplug = new HotplugClass(this);
+	connect(_hotplug, SIGNAL(portAdded(QString,int,int)), SLOT(_hotplug_portAdded(QString,int,int)));
+	if(!_vidPid.isEmpty())
+	{
+		if(!_hotplug->startNetlink())
+			_hotplug->startInotify("/dev");
+	}
+	else if(TransportClass::typeOf(_portName, false) == TransportClass::TypeEnum::Tcp)
+		// no device node: reconnect by polling
+		return;
+	else if(_portName.contains('/'))
+		// specified port path, example: /dev/pts/3
+		_hotplug->startInotify(QFileInfo(_portName).path());
+	else
+		_hotplug->startInotify("/dev");
+}
+
+void SerialPortClass::_hotplug_portAdded(QString portName, int vid, int pid)
+{
+	if(isPortOpen() || isReplay())
+		return;
+	TRACE_SCOPE("serial", "hotplug probe");
+	if(_vidPid.isEmpty())
+	{
+		// specified port
+		if(portName == _portName || QFileInfo(_portName).fileName() == portName)
+			if(openSerialPort(PortAndVidPid(_portName, _portName)))
+				stopReconnectTimer();
+		return;
+	}
+	foreach(VidPid vidPid, _vidPid)
+		if(vid == vidPid.first && pid == vidPid.second)
+		{
+			if(openSerialPort(PortAndVidPid(portName,
+				QString("hotplug %0 USB %1:%2").arg(portName)
+					.arg(vid, 2, 16, QLatin1Char('0'))
+					.arg(pid, 2, 16, QLatin1Char('0')))))
+				stopReconnectTimer();
+			return;
+		}
+}
+
 SerialPortClass::PortAndVidPid SerialPortClass::tryFindComPort()
 {
 	if(_vidPid.isEmpty())
 		// not need to search com port since it specified
 		return PortAndVidPid(_portName, _portName);
 
+	auto ports = findComPorts();
+	if(ports.isEmpty())
+		// port with USB VID:PID not found
+		return PortAndVidPid(QString(), QString());
+	if(_probeRequest.isEmpty())
+		return ports.first();
+	probeComPorts(ports);
+	return PortAndVidPid(QString(), QString());
+}
+
+QList<SerialPortClass::PortAndVidPid> SerialPortClass::findComPorts()
+{
+	QList<PortAndVidPid> ret;
 	// try to search com port according to VID:PID list
 	foreach(const QSerialPortInfo &info, QSerialPortInfo::availablePorts())
 	{
-		if(!info.isBusy() && info.hasVendorIdentifier() && info.hasProductIdentifier())
+		if(!info.isBusy() && info.hasVendorIdentifier() && info.hasProductIdentifier() && !isPortClaimed(info.portName()))
 			foreach(VidPid vidPid, _vidPid)
 			{
 				if(info.vendorIdentifier() == vidPid.first
 					&& info.productIdentifier() == vidPid.second)
-					return PortAndVidPid(info.portName(),
+				{
+					ret.append(PortAndVidPid(info.portName(),
 						QString("found %0 USB %1:%2").arg(info.portName())
 							.arg(info.vendorIdentifier(), 2, 16, QLatin1Char('0'))
 							.arg(info.productIdentifier(), 2, 16, QLatin1Char('0'))
-						);
+						));
+					break;
+				}
 			}
 	}
+	return ret;
+}
 
-	// port with USB VID:PID not found
-	return PortAndVidPid(QString(), QString());
+void SerialPortClass::probeComPorts(QList<PortAndVidPid> ports)
+{
+	TRACE_SCOPE("serial", "probe");
+	// one thread per port: all probes take one probe time
+	_probePool.setMaxThreadCount(ports.size());
+	_probedPorts = ports;
+	auto baud = _baud;
+	auto dataBits = _dataBits;
+	auto parity = _parity;
+	auto stopBits = _stopBits;
+	auto request = _probeRequest;
+	auto openDelay = _probeOpenDelay;
+	auto timeout = _probeTimeout;
+	auto capture = &_capture;
+	foreach(auto port, ports)
+	{
+		auto portName = port.first;
+		auto probe = new QFutureWatcher<ProbeResult>(this);
+		connect(probe, SIGNAL(finished()), SLOT(_probe_finished()));
+		probe->setFuture(QtConcurrent::run(&_probePool, [=] {
+			return _port::probe(portName, baud, dataBits, parity, stopBits, request, openDelay, timeout, capture);
+		}));
+		_probes.append(probe);
+	}
+}
+
+void SerialPortClass::_probe_finished()
+{
+	foreach(auto probe, _probes)
+		if(!probe->isFinished())
+			return;
+
+	// all probes complete: the capture gets the exchanges of all candidates
+	auto ports = _probedPorts;
+	auto probes = _probes;
+	_probedPorts.clear();
+	_probes.clear();
+	QVector<ProbeResult> results;
+	for(int i = 0; i < ports.size(); i++)
+	{
+		results.append(probes[i]->result());
+		// this slot is called by its finished()
+		probes[i]->deleteLater();
+		_capture.write(WireTraceClass::DirectionEnum::Probe, ports[i].first.toUtf8());
+		foreach(const auto &record, results[i].exchange)
+			_capture.write(record);
+	}
+
+	for(int i = 0; i < ports.size(); i++)
+	{
+		auto &answer = results[i].answer;
+		LOG_DEBUG(Serial, QString("probe %0: %1").arg(ports[i].first).arg(QString(answer).trimmed()));
+		if(!answer.isEmpty() && probeMatches(answer) && !isPortOpen())
+		{
+			_probeAnswer = answer;
+			if(openSerialPort(ports[i]))
+				stopReconnectTimer();
+			return;
+		}
+	}
+}
+
+void SerialPortClass::stopProbes()
+{
+	// running probes complete in the pool
+	foreach(auto probe, _probes)
+		probe->deleteLater();
+	_probes.clear();
+	_probedPorts.clear();
 }
 
 bool SerialPortClass::openSerialPort(SerialPortClass::PortAndVidPid portAndVidPid)
 {
+	TRACE_SCOPE("serial", "open");
 	// close serial port
+	closeSerialPort(false);
 
-	if(_serialPort != nullptr)
-		_serialPort->close();
-
-	// open serial port
-	_serialPort = new QSerialPort(portAndVidPid.first, this);
-	// setup serial port with parameters
-	_serialPort->setBaudRate(_baud);
-	_serialPort->setDataBits(_dataBits);
-	_serialPort->setParity(_parity);
-	_serialPort->setStopBits(_stopBits);
-	// open serial port
-	if(!_serialPort->open(QIODevice::ReadWrite))
+	// another device of the process may find the same port
+	if(!claimPort(portAndVidPid.first))
+		return false;
+
+	// the transport object is reused by all open attempts of the same type
+	auto type = TransportClass::typeOf(portAndVidPid.first, _nativeBackend);
+	if(_transport && _transport->type() != type)
 	{
-		if(_serialPort->error() != _lastError)
+		delete _transport;
+		_transport = nullptr;
+	}
+	if(_transport == nullptr)
+		_transport = TransportClass::create(type, this);
+	_transport->setSerialParameters(_baud, _dataBits, _parity, _stopBits);
+
+	// open transport
+	if(!_transport->open(portAndVidPid.first))
+	{
+		if(_transport->errorString() != _lastError)
 		{
-			Log::error(QString("error  %0: (%1) %2").arg(portAndVidPid.first)
-				.arg(_serialPort->error()).arg(_serialPort->errorString()));
-			_lastError = _serialPort->error();
-			if(_serialPort->isOpen())
-				_serialPort->close();
-			_serialPort = nullptr;
+			LOG_ERROR(Serial, QString("error  %0: %1").arg(portAndVidPid.first).arg(_transport->errorString()));
+			_lastError = _transport->errorString();
 		}
+		releasePort(portAndVidPid.first);
+		_probeAnswer.clear();
 		return false;
 	}
-	else
+
+	// connect transport signals
+	connect(_transport, SIGNAL(readyRead()), this, SLOT(_transport_readyRead()));
+	connect(_transport, SIGNAL(errorOccurred(QString)), this, SLOT(_transport_errorOccurred(QString)));
+
+	if(!_transport->isOpen())
 	{
-		Log::error(QString("opened %0 @ %1").arg(portAndVidPid.second).arg(_port::parameters(_serialPort)));
+		// connection in progress, example: TCP; the reconnect timer keeps running until opened()
+		_opening = portAndVidPid;
+		connect(_transport, SIGNAL(opened()), this, SLOT(_transport_opened()));
+		return false;
 	}
+	transportOpened(portAndVidPid);
+	return true;
+}
+
+void SerialPortClass::_transport_opened()
+{
+	disconnect(_transport, SIGNAL(opened()), this, SLOT(_transport_opened()));
+	auto portAndVidPid = _opening;
+	_opening = PortAndVidPid();
+	stopReconnectTimer();
+	transportOpened(portAndVidPid);
+}
+
+void SerialPortClass::transportOpened(PortAndVidPid portAndVidPid)
+{
+	LOG_WARNING(Serial, QString("opened %0 @ %1").arg(portAndVidPid.second).arg(_transport->description()));
 
-	// connect serial port signals
-	connect(_serialPort, SIGNAL(readyRead()), this, SLOT(_serialPort_readyRead()));
-	connect(_serialPort, SIGNAL(errorOccurred(QSerialPort::SerialPortError)),
-		this, SLOT(_serialPort_errorOccurred(QSerialPort::SerialPortError)));
+	_capture.write(WireTraceClass::DirectionEnum::Open, portAndVidPid.first.toUtf8());
+	traceReconnectEnd();
 
 	portOpened();
 	emit serialPortOpened(portAndVidPid.first);
-
-	return true;
 }
 
 void SerialPortClass::closeSerialPort(bool emitSignals)
 {
-	if(_serialPort)
+	TRACE_SCOPE("serial", "close");
+	stopProbes();
+	if(_transport && !_opening.first.isEmpty())
 	{
-		auto portName = _serialPort->portName();
+		// connection failed or abandoned before opened: like failed open
+		if(!_transport->errorString().isEmpty() && _transport->errorString() != _lastError)
+		{
+			LOG_ERROR(Serial, QString("error  %0: %1").arg(_opening.first).arg(_transport->errorString()));
+			_lastError = _transport->errorString();
+		}
+		disconnect(_transport, nullptr, this, nullptr);
+		_transport->close();
+		releasePort(_opening.first);
+		_opening = PortAndVidPid();
+		_probeAnswer.clear();
+	}
+	else if(_transport && _transport->isOpen())
+	{
+		auto portName = _transport->portName();
 		// filter
-		_lastError = _serialPort->error();
+		_lastError = _transport->errorString();
 		// log
-		if(_serialPort->error() == QSerialPort::NoError)
-			Log::error(QString("closed ") + qPrintable(portName));
+		if(_lastError.isEmpty())
+			LOG_WARNING(Serial, QString("closed ") + portName);
 		else
-			Log::error(QString("closed %0: (%1) %2").arg(portName)
-				.arg(_serialPort->error()).arg(_serialPort->errorString()));
-		// close port
-		if(_serialPort->isOpen())
-			_serialPort->close();
-		delete _serialPort;
-		_serialPort = nullptr;
+			LOG_WARNING(Serial, QString("closed %0: %1").arg(portName).arg(_lastError));
+		// close port, keep the object for the next open
+		disconnect(_transport, nullptr, this, nullptr);
+		_transport->close();
+		releasePort(portName);
+		_probeAnswer.clear();
 
 		if(emitSignals)
 			emit serialPortClosed(portName);
 	}
+	else if(_replayOpen)
+	{
+		LOG_WARNING(Serial, QString("closed ") + _portName);
+		clearPort();
+		_replayOpen = false;
+
+		if(emitSignals)
+			emit serialPortClosed(_portName);
+	}
 
 	if(emitSignals)
 		portClosed();
@@ -287,6 +501,11 @@ void SerialPortClass::closeSerialPort(bool emitSignals)
 
 void SerialPortClass::closeSerialPortAndReconnect()
 {
+	if(!_traceReconnect && Trace::enabled())
+	{
+		_traceReconnect = true;
+		Trace::asyncBegin("serial", "reconnect", (quintptr)this);
+	}
 	closeSerialPort(true);
 
 	// start reconnect timer // start to search port in the system by timer
@@ -297,29 +516,186 @@ void SerialPortClass::closeSerialPortAndReconnect()
 	_reconnectTimerId = startTimer(0);
 }
 
-void SerialPortClass::_serialPort_readyRead()
+bool SerialPortClass::claimPort(QString portName)
+{
+	QMutexLocker locker(&_claimedMutex);
+	if(_claimedPorts.contains(portName))
+		return false;
+	_claimedPorts.insert(portName);
+	return true;
+}
+
+void SerialPortClass::releasePort(QString portName)
 {
-	auto buff = _serialPort->readAll();
-	if(buff.length() == 0)
+	QMutexLocker locker(&_claimedMutex);
+	_claimedPorts.remove(portName);
+}
+
+bool SerialPortClass::isPortClaimed(QString portName)
+{
+	QMutexLocker locker(&_claimedMutex);
+	return _claimedPorts.contains(portName);
+}
+
+void SerialPortClass::traceReconnectEnd()
+{
+	if(_traceReconnect)
 	{
-		Log::msg("SERR2");
-		if(_serialPort->error() != QSerialPort::NoError)
-			closeSerialPortAndReconnect();
+		_traceReconnect = false;
+		Trace::asyncEnd("serial", "reconnect", (quintptr)this);
 	}
-	else
+}
+
+void SerialPortClass::_transport_readyRead()
+{
+	TRACE_SCOPE("serial", "readyRead");
+	// read to inline buffer; dataArrived() may close the port
+	qint64 length = 0;
+	while(_transport->isOpen() && (length = _transport->read(_readBuffer, sizeof(_readBuffer))) > 0)
+	{
+		_capture.write(WireTraceClass::DirectionEnum::RX, _readBuffer, length);
+		dataArrived(_readBuffer, length);
+	}
+	if(length < 0 && _transport->isOpen())
 	{
-		dataArrived(buff);
+		LOG_WARNING_RATE_LIMITED(Serial, this, 1000, "SERR2");
+		closeSerialPortAndReconnect();
 	}
 }
 
-void SerialPortClass::_serialPort_errorOccurred(QSerialPort::SerialPortError error)
+void SerialPortClass::_transport_errorOccurred(QString error)
 {
-	Log::msg(QString("SERR: %0").arg(error));
-	if(error != QSerialPort::NoError)
-		closeSerialPortAndReconnect();
+	if(!_opening.first.isEmpty())
+	{
+		// connection failed: the reconnect timer is running
+		closeSerialPort(false);
+		return;
+	}
+	LOG_WARNING_RATE_LIMITED(Serial, this, 1000, QString("%0: SERR: %1").arg(objectName()).arg(error));
+	closeSerialPortAndReconnect();
+}
+
+void SerialPortClass::logData(const QByteArray &data, bool send)
+{
+	LOG_DATA(Data, data, send);
+}
+
+void SerialPortClass::logData(const char *data, int length, bool send)
+{
+	LOG_IF(Data, Debug, Log::data(data, length, send));
+}
+
+void SerialPortClass::writePort(const QByteArray &data)
+{
+	_capture.write(WireTraceClass::DirectionEnum::TX, data);
+	if(_replayOpen)
+		replayWrite(data);
+	else if(_transport && _transport->isOpen())
+		_transport->write(data);
 }
 
-void SerialPortClass::logData(QByteArray data, bool send)
+void SerialPortClass::clearPort()
 {
-	Log::data(_toEscapedCString(data), data.length(), send);
+	if(_replayOpen)
+	{
+		// discard not arrived data
+		_replayPending.clear();
+		if(_replayTimerId >= 0)
+		{
+			killTimer(_replayTimerId);
+			_replayTimerId = -1;
+		}
+	}
+	else if(_transport && _transport->isOpen())
+		_transport->clear();
+}
+
+void SerialPortClass::flushPort()
+{
+	if(_transport && _transport->isOpen())
+		_transport->flush();
+}
+
+bool SerialPortClass::openReplay()
+{
+	// skip to the port open record, collecting the probe answers of the candidate ports
+	auto &records = _replayTrace.records;
+	QHash<QByteArray, QByteArray> probeAnswers;
+	QByteArray probedPort;
+	while(_replayPos < records.size() && records[_replayPos].direction != WireTraceClass::DirectionEnum::Open)
+	{
+		auto &r = records[_replayPos++];
+		if(r.direction == WireTraceClass::DirectionEnum::Probe)
+		{
+			probedPort = r.data;
+			probeAnswers[probedPort].clear();
+		}
+		else if(r.direction == WireTraceClass::DirectionEnum::ProbeRX)
+			probeAnswers[probedPort] += r.data;
+	}
+	if(_replayPos >= records.size())
+	{
+		LOG_WARNING(Serial, QString("replay complete: %0 requests in %1 ms")
+			.arg(_replayRequestsCount).arg(_replayTimer.elapsed()));
+		return false;
+	}
+	// port found by probe: identified by the probe answer like the captured session, no IDN request follows
+	auto answer = probeAnswers.value(records[_replayPos++].data);
+	_probeAnswer = !answer.isEmpty() && probeMatches(answer) ? answer : QByteArray();
+
+	if(!_replayTimer.isValid())
+		_replayTimer.start();
+	_replayOpen = true;
+	traceReconnectEnd();
+	LOG_WARNING(Serial, QString("opened ") + _portName);
+	portOpened();
+	emit serialPortOpened(_portName);
+	return true;
+}
+
+void SerialPortClass::replayWrite(const QByteArray &data)
+{
+	clearPort();
+
+	// find written record
+	auto &records = _replayTrace.records;
+	while(_replayPos < records.size() && records[_replayPos].direction != WireTraceClass::DirectionEnum::TX)
+		_replayPos++;
+	if(_replayPos >= records.size())
+	{
+		// trace is over
+		closeSerialPort(true);
+		openReplay();
+		return;
+	}
+	if(records[_replayPos].data != data)
+		LOG_WARNING(Serial, QString("replay: request %0 differs from trace %1")
+			.arg(QString(data)).arg(QString(records[_replayPos].data)));
+	_replayRequestsCount++;
+
+	// read records following the written one
+	auto timestamp = records[_replayPos++].timestamp;
+	while(_replayPos < records.size() && records[_replayPos].direction == WireTraceClass::DirectionEnum::RX)
+		_replayPending.append(records[_replayPos++]);
+	if(!_replayPending.isEmpty())
+		_replayTimerId = startTimer(_replayRealTime ? (_replayPending.first().timestamp - timestamp) / 1000000 : 0,
+			Qt::PreciseTimer);
+}
+
+void SerialPortClass::processReplayTimer()
+{
+	killTimer(_replayTimerId);
+	_replayTimerId = -1;
+
+	while(!_replayPending.isEmpty())
+	{
+		auto r = _replayPending.takeFirst();
+		dataArrived(r.data.constData(), r.data.length());
+		// dataArrived() may clear pending records
+		if(_replayRealTime && !_replayPending.isEmpty())
+		{
+			_replayTimerId = startTimer((_replayPending.first().timestamp - r.timestamp) / 1000000, Qt::PreciseTimer);
+			break;
+		}
+	}
 }
@@ -3,7 +3,15 @@
 
 #include <QByteArray>
 #include <QVector>
+#include <QSet>
+#include <QMutex>
 #include <QSerialPort>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QFutureWatcher>
+#include "WireTraceClass.h"
+#include "HotplugClass.h"
+#include "TransportClass.h"
 
 class SerialPortClass : public QObject
 {
@@ -15,9 +23,37 @@ public:
 	//! @param vidPid	USB VID:PID list to search
 	explicit SerialPortClass(QVector<VidPid> vidPid, QObject *parent=NULL);
 
+	//! Opens the specified port instead of search by USB VID:PID
+	//! @param portName	Example: ttyACM0; /dev/pts/3; tcp://192.168.1.10:4001
+	void setPortName(QString portName);
+
+	//! Selects serial port backend for the next open; TCP addresses use TCP transport anyway
+	//! @param native	true - raw file descriptor with termios (Linux); false - QSerialPort
+	void setNativeBackend(bool native);
+
+	//! @return Answer timeout extension for the opened transport, ms
+	int latencyBudget() const { return _transport ? _transport->latencyBudget() : 0; }
+
+	//! Starts to capture bytes read & written to the wire trace file
+	bool setCapture(QString fileName);
+
+	//! Replays the wire trace file instead of serial port: written requests are matched with trace
+	//! and the following read bytes are fed to dataArrived()
+	//! @param realTime	true - with original timing; false - as fast as possible
+	bool setReplay(QString fileName, bool realTime);
+	bool isReplay() const { return !_replayTrace.records.isEmpty(); }
+
+	//! Probe of a candidate port
+	struct ProbeResult
+	{
+		QByteArray answer; //!< Empty - no answer
+		QVector<WireTraceClass::Record> exchange; //!< Probe TX & RX records for the capture
+	};
+
 public slots:
 	//! Opens com port
 	//! @param portName example: ttyACM0
+	//! @return true - opened; false - failed or connection is in progress, serialPortOpened() follows on success
 	bool openSerialPort(PortAndVidPid portAndVidPid);
 	void closeSerialPort(bool emitSignals);
 	void closeSerialPortAndReconnect();
@@ -27,43 +63,115 @@ signals:
 	void serialPortClosed(QString portName);
 
 protected slots:
-	void _serialPort_readyRead();
-	void _serialPort_errorOccurred(QSerialPort::SerialPortError error);
-
+	void _transport_readyRead();
+	void _transport_errorOccurred(QString error);
+	void _transport_opened();
+	void _probe_finished();
+	void _hotplug_portAdded(QString portName, int vid, int pid);
 
 protected:
 	static constexpr int DEFAULT_BAUD = 9600;
 	static constexpr QSerialPort::DataBits DEFAULT_DATA_BITS = QSerialPort::Data8;
 	static constexpr QSerialPort::Parity DEFAULT_PARITY = QSerialPort::NoParity;
 	static constexpr QSerialPort::StopBits DEFAULT_STOP_BITS = QSerialPort::OneStop;
+	static constexpr int READ_BUFFER_SIZE = 256; //!< Serial port reads chunk, bytes
 
 	unsigned int _baud = DEFAULT_BAUD;
 	QSerialPort::DataBits _dataBits = DEFAULT_DATA_BITS;
 	QSerialPort::Parity _parity = DEFAULT_PARITY;
 	QSerialPort::StopBits _stopBits = DEFAULT_STOP_BITS;
 
-	QSerialPort *_serialPort = nullptr;	//!< Serial COM port
+	TransportClass *_transport = nullptr; //!< Serial COM port or TCP connection: reused by reconnects of the same type
+	bool _nativeBackend = false; //!< Open serial ports with NativeSerialPortClass instead of QSerialPort
+	char _readBuffer[READ_BUFFER_SIZE]; //!< Transport reads destination
 
 	QString _portName; //!< Port name to open
 	QVector<VidPid> _vidPid; //!< USB VID:PID list to search
 
 	int _reconnectTimerId = -1; //!< Com port find interval timer id: -1 - no timer; 0.. timer id
 	int _reconnectAttemptsCount = 0; //!< Com port find attempts count: 0..
-	QSerialPort::SerialPortError _lastError = QSerialPort::NoError; //! Error filter
+	QString _lastError; //!< Error filter
+
+	QByteArray _probeRequest; //!< Candidate ports are probed concurrently with the request: empty - no probe
+	int _probeOpenDelay = 0; //!< Delay after probed port opened, ms
+	int _probeTimeout = 0; //!< Probe answer timeout, ms
+	QByteArray _probeAnswer; //!< Probe answer of the opened port: empty - port is not probed
+	QList<PortAndVidPid> _probedPorts; //!< Candidates of the pending probes: empty - no probes pending
+	QList<QFutureWatcher<ProbeResult>*> _probes; //!< Pending probes of _probedPorts
+	PortAndVidPid _opening; //!< Port of the connection in progress: empty - none
+	HotplugClass *_hotplug = nullptr; //!< Ports appearance monitor; polling is fallback only if active
+
+	WireTraceClass _capture; //!< Wire capture
+
+	WireTraceClass _replayTrace; //!< Wire trace to replay
+	bool _replayRealTime = true; //!< Replay with original timing
+	bool _replayOpen = false; //!< Replay port opened
+	int _replayPos = 0; //!< Next record of the trace
+	QVector<WireTraceClass::Record> _replayPending; //!< Read records to feed to dataArrived()
+	int _replayTimerId = -1; //!< Pending records timer ID: -1 - timer not launched; 0..
+	QElapsedTimer _replayTimer; //!< Replay duration
+	int _replayRequestsCount = 0;
+
+	bool _traceReconnect = false; //!< Reconnect trace span is begun
+
+	QThreadPool _probePool; //!< A thread per candidate port; declared last: waits for the probes first on destruction
+
+	static QMutex _claimedMutex; //!< Protects _claimedPorts
+	static QSet<QString> _claimedPorts; //!< Ports opened by all instances: skipped by search of the others
 
 	void timerEvent(QTimerEvent *event) override;
 
 	virtual void portOpened() = 0;
 	virtual void portClosed() = 0;
-	virtual void dataArrived(QByteArray data) = 0;
+	//! @param data	Read bytes; valid during the call only
+	virtual void dataArrived(const char *data, int length) = 0;
 
 	void processReconnectTimer();
-
-	//! Tries to find not busy com port in the system
-	//! @return Com port path (if found) or empty string
+	//! Stops reconnect timer after port opened
+	void stopReconnectTimer();
+	//! Starts hotplug monitor: udev netlink or inotify on the port directory
+	void startHotplug();
+	//! Ends reconnect trace span if it is begun
+	void traceReconnectEnd();
+	//! @return false if the port is opened by another instance
+	static bool claimPort(QString portName);
+	static void releasePort(QString portName);
+	static bool isPortClaimed(QString portName);
+
+	bool isPortOpen() const
+	{
+		return _replayOpen || (_transport && _transport->isOpen());
+	}
+	//! Writes to serial port (or replays the trace) & captures written bytes
+	void writePort(const QByteArray &data);
+	//! Discards serial port buffers
+	void clearPort();
+	//! Sends batched written data
+	void flushPort();
+
+	//! Opens the trace for replay as serial port
+	bool openReplay();
+	//! Schedules trace records read after the written ones
+	void replayWrite(const QByteArray &data);
+	//! Feeds pending read records to dataArrived()
+	void processReplayTimer();
+
+	//! Tries to find not busy com port in the system; starts probes of candidates if probe request is set
+	//! @return Com port path (if found) or empty string: not found or probes are pending
 	PortAndVidPid tryFindComPort();
-
-	void logData(QByteArray data, bool send=false);
+	//! @return Not busy com ports with USB VID:PID from the list
+	QList<PortAndVidPid> findComPorts();
+	//! Starts probes of ports concurrently in _probePool; _probe_finished() opens the first port with matched answer
+	void probeComPorts(QList<PortAndVidPid> ports);
+	//! Abandons pending probes: their results are discarded
+	void stopProbes();
+	//! Completes open of the transport: starts the protocol
+	void transportOpened(PortAndVidPid portAndVidPid);
+	//! @return Whether probe answer identifies wanted device
+	virtual bool probeMatches(const QByteArray &answer) const { Q_UNUSED(answer) return true; }
+
+	void logData(const QByteArray &data, bool send=false);
+	void logData(const char *data, int length, bool send=false);
 };
 
 #endif // SerialPortClass_H
@@ -0,0 +1,71 @@
+#include "SerialTransportClass.h"
+
+SerialTransportClass::SerialTransportClass(QObject *parent) :
+	TransportClass(parent), _port(this)
+{
+	connect(&_port, SIGNAL(readyRead()), SIGNAL(readyRead()));
+	connect(&_port, SIGNAL(errorOccurred(QSerialPort::SerialPortError)),
+		SLOT(_port_errorOccurred(QSerialPort::SerialPortError)));
+}
+
+bool SerialTransportClass::open(QString portName)
+{
+	close();
+	_portName = portName;
+	_port.setPortName(portName);
+	_port.setBaudRate(_baud);
+	_port.setDataBits(_dataBits);
+	_port.setParity(_parity);
+	_port.setStopBits(_stopBits);
+	if(!_port.open(QIODevice::ReadWrite))
+	{
+		// keep the error for errorString()
+		_port.QIODevice::close();
+		return false;
+	}
+	return true;
+}
+
+void SerialTransportClass::close()
+{
+	if(_port.isOpen())
+		_port.close();
+	_port.clearError();
+}
+
+qint64 SerialTransportClass::read(char *data, qint64 maxLength)
+{
+	auto ret = _port.read(data, maxLength);
+	if(ret <= 0 && _port.error() != QSerialPort::NoError)
+		return -1;
+	return qMax<qint64>(ret, 0);
+}
+
+void SerialTransportClass::write(const QByteArray &data)
+{
+	_port.write(data);
+}
+
+void SerialTransportClass::flush()
+{
+	_port.flush();
+}
+
+void SerialTransportClass::clear()
+{
+	_port.clear();
+}
+
+QString SerialTransportClass::errorString() const
+{
+	if(_port.error() == QSerialPort::NoError)
+		return QString();
+	return QString("(%0) %1").arg(_port.error()).arg(_port.errorString());
+}
+
+void SerialTransportClass::_port_errorOccurred(QSerialPort::SerialPortError error)
+{
+	// open errors are returned by open()
+	if(error != QSerialPort::NoError && _port.isOpen())
+		emit errorOccurred(errorString());
+}
@@ -0,0 +1,36 @@
+#ifndef SerialTransportClass_H
+#define SerialTransportClass_H
+
+#include <QSerialPort>
+#include "TransportClass.h"
+
+//! Serial port transport on QSerialPort
+class SerialTransportClass : public TransportClass
+{
+	Q_OBJECT
+
+public:
+	explicit SerialTransportClass(QObject *parent=NULL);
+
+	TypeEnum type() const override { return TypeEnum::Serial; }
+
+	bool open(QString portName) override;
+	void close() override;
+	bool isOpen() const override { return _port.isOpen(); }
+
+	qint64 read(char *data, qint64 maxLength) override;
+	void write(const QByteArray &data) override;
+	void flush() override;
+	void clear() override;
+
+	QString errorString() const override;
+	QString description() const override { return serialParameters(); }
+
+protected slots:
+	void _port_errorOccurred(QSerialPort::SerialPortError error);
+
+protected:
+	QSerialPort _port;
+};
+
+#endif // SerialTransportClass_H
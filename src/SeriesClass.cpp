@@ -0,0 +1,29 @@
+#include <math.h>
+#include <algorithm>
+#include "SeriesClass.h"
+
+void SeriesClass::setColumns(int columns)
+{
+	auto old = _values.size();
+	_values.resize(columns);
+	for(int i = old; i < columns; i++)
+		_values[i].fill(NAN, _keys.size());
+}
+
+void SeriesClass::append(double key)
+{
+	_keys.append(key);
+	for(auto &column : _values)
+		column.append(NAN);
+}
+
+void SeriesClass::setLast(int column, float value)
+{
+	if(!_keys.isEmpty() && column < _values.size())
+		_values[column].last() = value;
+}
+
+int SeriesClass::lowerBound(double key) const
+{
+	return std::lower_bound(_keys.constBegin(), _keys.constEnd(), key) - _keys.constBegin();
+}
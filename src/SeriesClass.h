@@ -0,0 +1,41 @@
+#ifndef SeriesClass_H
+#define SeriesClass_H
+
+#include <QVector>
+
+//! Samples of several channels sharing one key array: a row per poll cycle
+//! Keys are stored once for all channels; values are stored by column as float,
+//! so a channel costs 4 bytes per row instead of a key & value pair per graph point
+//! The row key is the poll cycle start instant (DeviceClass::Sample::cycle); the columns are sampled later
+//! in the same cycle & are drawn skewed back by their cycle position: up to a cycle period, example:
+//! IOUT2? of a dual channel PSU polled back to back at 20 ms round trip is 60 ms late
+class SeriesClass
+{
+public:
+	explicit SeriesClass(int columns = 0) { setColumns(columns); }
+
+	int columns() const { return _values.size(); }
+	//! Adds or removes columns; added columns are NAN for the existing rows
+	void setColumns(int columns);
+
+	int size() const { return _keys.size(); }
+	bool isEmpty() const { return _keys.isEmpty(); }
+	double key(int row) const { return _keys[row]; }
+	float value(int column, int row) const { return _values[column][row]; }
+	//! @return The value of the last row: NAN if not set
+	float last(int column) const { return _values[column].last(); }
+
+	//! Appends row with NAN values
+	void append(double key);
+	//! Sets the value of the last row
+	void setLast(int column, float value);
+
+	//! @return The first row with key not less than the key: 0..size()
+	int lowerBound(double key) const;
+
+protected:
+	QVector<double> _keys;
+	QVector<QVector<float> > _values; //!< By column
+};
+
+#endif // SeriesClass_H
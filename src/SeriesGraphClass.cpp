@@ -0,0 +1,173 @@
+#include <math.h>
+#include "Trace.h"
+#include "SeriesGraphClass.h"
+
+SeriesGraphClass::SeriesGraphClass(QCPAxis *keyAxis, QCPAxis *valueAxis, QSharedPointer<SeriesClass> series,
+	int column) :
+	QCPAbstractPlottable(keyAxis, valueAxis), _series(series), _column(column)
+{
+	setSelectable(QCP::stNone);
+}
+
+bool SeriesGraphClass::inDomain(double value, QCP::SignDomain domain)
+{
+	switch(domain)
+	{
+		case QCP::sdNegative: return value < 0;
+		case QCP::sdPositive: return value > 0;
+		default: return true;
+	}
+}
+
+float SeriesGraphClass::nearest(double *key) const
+{
+	auto &s = *_series;
+	if(s.isEmpty() || _column >= s.columns())
+		return NAN;
+	// the nearest rows at both sides, skipping rows without the value: a gap is scanned up to NEAREST_SCAN rows
+	int right = s.lowerBound(*key), left = right - 1;
+	int rightEnd = qMin(s.size(), right + NEAREST_SCAN), leftEnd = qMax(-1, left - NEAREST_SCAN);
+	while(right < rightEnd && qIsNaN(s.value(_column, right)))
+		right++;
+	if(right == rightEnd)
+		right = -1;
+	// rows farther than the right one can't be the nearest
+	while(left > leftEnd && qIsNaN(s.value(_column, left)) && (right < 0 || *key - s.key(left) <= s.key(right) - *key))
+		left--;
+	if(left == leftEnd || qIsNaN(s.value(_column, left)))
+		left = -1;
+	int row = right < 0 ? left : left < 0 ? right : (*key - s.key(left) <= s.key(right) - *key ? left : right);
+	if(row < 0)
+		return NAN;
+	*key = s.key(row);
+	return s.value(_column, row);
+}
+
+double SeriesGraphClass::selectTest(const QPointF &pos, bool onlySelectable, QVariant *details) const
+{
+	Q_UNUSED(pos) Q_UNUSED(onlySelectable) Q_UNUSED(details)
+	return -1;
+}
+
+QCPRange SeriesGraphClass::getKeyRange(bool &foundRange, QCP::SignDomain inSignDomain) const
+{
+	auto &s = *_series;
+	// keys are sorted: the domain bounds are found by binary search
+	int begin = 0, end = s.size();
+	if(inSignDomain == QCP::sdPositive)
+	{
+		begin = s.lowerBound(0);
+		while(begin < end && s.key(begin) <= 0)
+			begin++;
+	}
+	else if(inSignDomain == QCP::sdNegative)
+		end = s.lowerBound(0);
+	foundRange = begin < end;
+	return foundRange ? QCPRange(s.key(begin), s.key(end - 1)) : QCPRange();
+}
+
+QCPRange SeriesGraphClass::getValueRange(bool &foundRange, QCP::SignDomain inSignDomain, const QCPRange &inKeyRange) const
+{
+	auto &s = *_series;
+	QCPRange ret;
+	foundRange = false;
+	if(_column >= s.columns())
+		return ret;
+	bool all = inKeyRange == QCPRange();
+	int begin = all ? 0 : s.lowerBound(inKeyRange.lower);
+	int end = all ? s.size() : s.lowerBound(inKeyRange.upper);
+	if(!all)
+		// the row at the upper bound
+		end = qMin(end + 1, s.size());
+	for(int i = begin; i < end; i++)
+	{
+		double v = s.value(_column, i);
+		if(qIsNaN(v) || !inDomain(v, inSignDomain) || (!all && s.key(i) > inKeyRange.upper))
+			continue;
+		if(!foundRange)
+			ret.lower = ret.upper = v;
+		foundRange = true;
+		ret.lower = qMin(ret.lower, v);
+		ret.upper = qMax(ret.upper, v);
+	}
+	return ret;
+}
+
+void SeriesGraphClass::draw(QCPPainter *painter)
+{
+	TRACE_SCOPE("render", "series graph");
+	auto &s = *_series;
+	auto keyAxis = mKeyAxis.data();
+	if(!keyAxis || !mValueAxis || s.isEmpty() || _column >= s.columns() || mPen.style() == Qt::NoPen)
+		return;
+
+	// visible rows & one row beyond each side to draw lines to the edges
+	auto range = keyAxis->range();
+	int begin = qMax(0, s.lowerBound(range.lower) - 1);
+	int end = qMin(s.size(), s.lowerBound(range.upper) + 1);
+	// more than 2 rows per pixel: min/max per pixel column
+	bool decimate = end - begin > 2 * keyAxis->axisRect()->width();
+
+	painter->setPen(mPen);
+	painter->setBrush(Qt::NoBrush);
+	applyDefaultAntialiasingHint(painter);
+	QVector<QPointF> line;
+	line.reserve(decimate ? 4 * keyAxis->axisRect()->width() + 4 : end - begin);
+	int column = INT_MIN; //!< Decimated pixel column
+	double first = 0, last = 0, min = 0, max = 0; //!< Decimated values pixels
+	auto flushColumn = [&] {
+		if(column == INT_MIN)
+			return;
+		line.append(QPointF(column, first));
+		if(min != first && min != last)
+			line.append(QPointF(column, min));
+		if(max != first && max != last)
+			line.append(QPointF(column, max));
+		if(last != first)
+			line.append(QPointF(column, last));
+		column = INT_MIN;
+	};
+	auto flushLine = [&] {
+		flushColumn();
+		if(line.size() > 1)
+			painter->drawPolyline(line.constData(), line.size());
+		line.clear();
+	};
+	for(int i = begin; i < end; i++)
+	{
+		float v = s.value(_column, i);
+		if(qIsNaN(v))
+		{
+			// gap
+			flushLine();
+			continue;
+		}
+		auto p = coordsToPixels(s.key(i), v);
+		if(!decimate)
+		{
+			line.append(p);
+			continue;
+		}
+		int x = qRound(p.x());
+		if(x != column)
+		{
+			flushColumn();
+			column = x;
+			first = min = max = last = p.y();
+		}
+		else
+		{
+			last = p.y();
+			min = qMin(min, last);
+			max = qMax(max, last);
+		}
+	}
+	flushLine();
+}
+
+void SeriesGraphClass::drawLegendIcon(QCPPainter *painter, const QRectF &rect) const
+{
+	applyDefaultAntialiasingHint(painter);
+	painter->setPen(mPen);
+	painter->drawLine(QLineF(rect.left(), rect.center().y() + 1, rect.right(), rect.center().y() + 1));
+}
@@ -0,0 +1,42 @@
+#ifndef SeriesGraphClass_H
+#define SeriesGraphClass_H
+
+#include <QSharedPointer>
+#include "qcustomplot.h"
+#include "SeriesClass.h"
+
+//! Line graph of one SeriesClass column: graphs of all channels share the series keys
+//! Visible rows are found by binary search & decimated to min/max per pixel column when dense
+class SeriesGraphClass : public QCPAbstractPlottable
+{
+	Q_OBJECT
+
+public:
+	//! Key axis is horizontal
+	SeriesGraphClass(QCPAxis *keyAxis, QCPAxis *valueAxis, QSharedPointer<SeriesClass> series, int column);
+
+	QSharedPointer<SeriesClass> series() const { return _series; }
+	int column() const { return _column; }
+
+	static constexpr int NEAREST_SCAN = 256; //!< Rows without value skipped at each side of the key, at most
+
+	//! @return Value at the nearest row with value to the key: NAN if no values within NEAREST_SCAN rows
+	//! @param key	Nearest row key is returned
+	float nearest(double *key) const;
+
+	double selectTest(const QPointF &pos, bool onlySelectable, QVariant *details=0) const override;
+	QCPRange getKeyRange(bool &foundRange, QCP::SignDomain inSignDomain=QCP::sdBoth) const override;
+	QCPRange getValueRange(bool &foundRange, QCP::SignDomain inSignDomain=QCP::sdBoth,
+		const QCPRange &inKeyRange=QCPRange()) const override;
+
+protected:
+	QSharedPointer<SeriesClass> _series;
+	int _column;
+
+	void draw(QCPPainter *painter) override;
+	void drawLegendIcon(QCPPainter *painter, const QRectF &rect) const override;
+
+	static bool inDomain(double value, QCP::SignDomain domain);
+};
+
+#endif // SeriesGraphClass_H
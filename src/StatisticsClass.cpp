@@ -0,0 +1,87 @@
+#include "StatisticsClass.h"
+
+int HistogramClass::bucketIndex(quint64 value)
+{
+	if(value < SUB_BUCKETS)
+		// linear range
+		return value;
+	if(value >> VALUE_BITS)
+		return BUCKETS - 1;
+	// most significant bit position
+	int msb = SUB_BUCKETS_BITS;
+	while(value >> (msb + 1))
+		msb++;
+	int shift = msb - (SUB_BUCKETS_BITS - 1);
+	return SUB_BUCKETS + (shift - 1) * (SUB_BUCKETS / 2) + (value >> shift) - SUB_BUCKETS / 2;
+}
+
+quint64 HistogramClass::bucketValue(int index)
+{
+	if(index < SUB_BUCKETS)
+		return index;
+	index -= SUB_BUCKETS;
+	int shift = index / (SUB_BUCKETS / 2) + 1;
+	return (quint64)(index % (SUB_BUCKETS / 2) + SUB_BUCKETS / 2) << shift;
+}
+
+void HistogramClass::record(quint64 value)
+{
+	_counts[bucketIndex(value)]++;
+	if(!_count || value < _min)
+		_min = value;
+	if(value > _max)
+		_max = value;
+	_count++;
+	_sum += value;
+}
+
+quint64 HistogramClass::quantile(double q) const
+{
+	if(!_count)
+		return 0;
+	quint64 rank = q * (_count - 1) + 1, sum = 0;
+	for(int i = 0; i < BUCKETS; i++)
+	{
+		sum += _counts[i];
+		if(sum >= rank)
+			return qBound(_min, bucketValue(i), _max);
+	}
+	return _max;
+}
+
+void HistogramClass::merge(const HistogramClass &other)
+{
+	if(!other._count)
+		return;
+	for(int i = 0; i < BUCKETS; i++)
+		_counts[i] += other._counts[i];
+	if(!_count || other._min < _min)
+		_min = other._min;
+	if(other._max > _max)
+		_max = other._max;
+	_count += other._count;
+	_sum += other._sum;
+}
+
+QString StatisticsClass::toText(QString (*requestName)(int)) const
+{
+	QString ret = QString("requests %0\nanswers %1\ntimeouts %2\nreconnects %3\n"
+		"bytes_in %4\nbytes_out %5\ndropped_requests %6\nduplicate_requests %7\nparse_failures %8\npending_requests %9\n"
+			"resync_resends %10\nresync_pings %11\nresync_reconnects %12\nunsupported_requests %13\nstatus_events %14\n")
+		.arg(requests).arg(answers).arg(timeouts).arg(reconnects)
+		.arg(bytesIn).arg(bytesOut).arg(droppedRequests).arg(duplicateRequests).arg(parseFailures).arg(pendingRequests)
+		.arg(resyncResends).arg(resyncPings).arg(resyncReconnects).arg(unsupportedRequests).arg(statusEvents);
+	for(auto it = latency.constBegin(); it != latency.constEnd(); ++it)
+	{
+		auto &h = it.value();
+		ret += QString("latency %0: count %1 min %2 p50 %3 p90 %4 p99 %5 max %6 mean %7 us\n")
+			.arg(requestName(it.key())).arg(h.count()).arg(h.min())
+			.arg(h.quantile(0.5)).arg(h.quantile(0.9)).arg(h.quantile(0.99)).arg(h.max())
+			.arg(h.mean(), 0, 'f', 0);
+	}
+	if(statusEventLatency.count())
+		ret += QString("status event latency: count %0 min %1 p50 %2 p99 %3 max %4 us\n")
+			.arg(statusEventLatency.count()).arg(statusEventLatency.min()).arg(statusEventLatency.quantile(0.5))
+			.arg(statusEventLatency.quantile(0.99)).arg(statusEventLatency.max());
+	return ret;
+}
@@ -0,0 +1,69 @@
+#ifndef StatisticsClass_H
+#define StatisticsClass_H
+
+#include <QString>
+#include <QMap>
+
+//! Latency histogram with logarithmic buckets, each divided to linear sub-buckets (HDR-style)
+//! Values are recorded with ~6% precision in range 0..2^32
+class HistogramClass
+{
+public:
+	void record(quint64 value);
+
+	quint64 count() const { return _count; }
+	quint64 min() const { return _count ? _min : 0; }
+	quint64 max() const { return _max; }
+	quint64 sum() const { return _sum; }
+	double mean() const { return _count ? (double)_sum / _count : 0.; }
+
+	//! @param q	Quantile: 0..1
+	//! @return Value lower bound of the bucket containing the quantile
+	quint64 quantile(double q) const;
+
+	void merge(const HistogramClass &other);
+
+protected:
+	static constexpr int SUB_BUCKETS_BITS = 4; //!< Sub-buckets per power of 2: 16
+	static constexpr int SUB_BUCKETS = 1 << SUB_BUCKETS_BITS;
+	static constexpr int VALUE_BITS = 32; //!< Values above 2^32 are recorded as max
+	static constexpr int BUCKETS = SUB_BUCKETS + (VALUE_BITS - SUB_BUCKETS_BITS) * (SUB_BUCKETS / 2);
+
+	quint64 _counts[BUCKETS] = {};
+	quint64 _count = 0;
+	quint64 _sum = 0;
+	quint64 _min = 0;
+	quint64 _max = 0;
+
+	static int bucketIndex(quint64 value);
+	static quint64 bucketValue(int index);
+};
+
+//! Protocol counters & per-request latency histograms
+class StatisticsClass
+{
+public:
+	quint64 requests = 0; //!< Sent requests count
+	quint64 answers = 0; //!< Completed answers count
+	quint64 timeouts = 0; //!< Answer timeouts count
+	quint64 reconnects = 0; //!< Port closes with reconnect count
+	quint64 bytesIn = 0; //!< Read bytes count
+	quint64 bytesOut = 0; //!< Written bytes count
+	quint64 droppedRequests = 0; //!< Requests ignored since PSU model not detected
+	quint64 duplicateRequests = 0; //!< Requests ignored since the same request is pending
+	quint64 parseFailures = 0; //!< Answers that can't be parsed
+	quint64 unsupportedRequests = 0; //!< Requests ignored since PSU model doesn't support them
+	int pendingRequests = 0; //!< Requests waiting for answer: 0..1
+	quint64 resyncResends = 0; //!< Timeouts resolved by drain & resend
+	quint64 resyncPings = 0; //!< Timeouts resolved by IDN ping & resend
+	quint64 resyncReconnects = 0; //!< Timeouts resolved by full reconnect
+	quint64 statusEvents = 0; //!< Status edges detected by status polls
+	HistogramClass statusEventLatency; //!< Previous status poll instant to edges notification by status poll, us
+
+	QMap<int, HistogramClass> latency; //!< Request to last answer byte latency by request, us
+
+	//! @param requestName	Returns request name by the latency key
+	QString toText(QString (*requestName)(int)) const;
+};
+
+#endif // StatisticsClass_H
@@ -0,0 +1,54 @@
+#include <QString>
+#include "StatusClass.h"
+
+StatusClass::TrackingEnum StatusClass::tracking() const
+{
+	// 01 - series; 11 - parallel
+	switch((_bits >> 2) & 3)
+	{
+		case 1: return Series;
+		case 3: return Parallel;
+		default: return Independent;
+	}
+}
+
+void StatusClass::edges(const StatusClass &previous, int channels, bool outputOffRequested, quint64 timestamp,
+	quint64 window, QVector<Event> *events) const
+{
+	if(*this == previous)
+		return;
+	for(int ch = 0; ch < qMin(channels, 2); ch++)
+		if(cv(ch) != previous.cv(ch))
+			events->append({ cv(ch) ? CvEntered : CcEntered, ch, timestamp, window });
+	if(output() == previous.output())
+		return;
+	events->append({ output() ? OutputOn : OutputOff, 0, timestamp, window });
+	if(output() || outputOffRequested)
+		return;
+	// PSU reports protections enabled, not tripped: the mode before the output off tells which one tripped
+	// (front panel OUTPUT key in CV with OVP on is reported as OVP trip too)
+	if(previous.ocp() && previous.cc(0))
+		events->append({ OcpTrip, 0, timestamp, window });
+	else if(previous.ovp() && previous.cv(0))
+		events->append({ OvpTrip, 0, timestamp, window });
+}
+
+const char *StatusClass::eventName(EventEnum event)
+{
+	switch(event)
+	{
+		case CcEntered: return "CC entered";
+		case CvEntered: return "CV entered";
+		case OutputOn: return "output on";
+		case OutputOff: return "output off";
+		case OvpTrip: return "OVP trip";
+		case OcpTrip: return "OCP trip";
+	}
+	return "?";
+}
+
+QString StatusClass::toText() const
+{
+	return QString("%0, output %1, OVP %2, OCP %3")
+		.arg(cv(0) ? "CV" : "CC").arg(output() ? "on" : "off").arg(ovp() ? "on" : "off").arg(ocp() ? "on" : "off");
+}
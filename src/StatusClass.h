@@ -0,0 +1,72 @@
+#ifndef StatusClass_H
+#define StatusClass_H
+
+#include <QVector>
+#include <QMetaType>
+
+//! STATUS? answer byte decoded to bitfield
+//! Bits: 0 - CH1 CV; 1 - CH2 CV; 2..3 - tracking; 4 - beep; 5 - OCP on; 6 - output on; 7 - OVP on
+class StatusClass
+{
+public:
+	//! Edge of the status between 2 polls
+	enum EventEnum
+	{
+		CcEntered, //!< CV→CC: current limit reached
+		CvEntered, //!< CC→CV
+		OutputOn,
+		OutputOff, //!< By user or protection
+		OvpTrip, //!< Output off not requested by OUT0, with OVP on while in CV
+		OcpTrip, //!< Output off not requested by OUT0, with OCP on while in CC
+	};
+
+	//! Detected edge
+	struct Event
+	{
+		EventEnum type;
+		int channel; //!< 0 - CH1; 1 - CH2; output & protection events are of CH1
+		quint64 timestamp; //!< PSU status instant estimate of the poll detected the edge, Log::timestamp(), ns
+		quint64 window; //!< Since the previous status poll, ns: the edge is within (timestamp - window, timestamp]
+	};
+
+	//! Tracking mode bits
+	enum TrackingEnum
+	{
+		Independent = 0,
+		Series = 1,
+		Parallel = 2,
+	};
+
+	explicit StatusClass(quint8 bits=0) : _bits(bits) {}
+
+	quint8 bits() const { return _bits; }
+	//! @param channel	0..1
+	bool cv(int channel) const { return _bits & (1 << channel); }
+	bool cc(int channel) const { return !cv(channel); }
+	TrackingEnum tracking() const;
+	bool beep() const { return _bits & (1 << 4); }
+	bool ocp() const { return _bits & (1 << 5); }
+	bool output() const { return _bits & (1 << 6); }
+	bool ovp() const { return _bits & (1 << 7); }
+
+	bool operator==(const StatusClass &other) const { return _bits == other._bits; }
+	bool operator!=(const StatusClass &other) const { return _bits != other._bits; }
+
+	//! Appends edges from the previous status to this one; a trip follows its OutputOff
+	//! @param channels	PSU channels count: CH2 mode bit is ignored by single channel models
+	//! @param outputOffRequested	OUT0 was sent since the previous status: output off isn't a trip
+	void edges(const StatusClass &previous, int channels, bool outputOffRequested, quint64 timestamp, quint64 window,
+		QVector<Event> *events) const;
+
+	//! @return Event name, example: "OCP trip"
+	static const char *eventName(EventEnum event);
+	//! @return Example: "CV, output on, OCP on"
+	QString toText() const;
+
+protected:
+	quint8 _bits;
+};
+
+Q_DECLARE_METATYPE(StatusClass::Event)
+
+#endif // StatusClass_H
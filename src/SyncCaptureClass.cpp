@@ -0,0 +1,163 @@
+#include <math.h>
+#include "Log.h"
+#include "Trace.h"
+#include "SyncCaptureClass.h"
+
+constexpr int SyncCaptureClass::ROUND_TIMEOUT;
+constexpr int SyncCaptureClass::DEVICE_CHANNELS;
+
+SyncCaptureClass::SyncCaptureClass(DeviceManagerClass *devices, QObject *parent) :
+	QObject(parent), _devices(devices)
+{
+	for(int i = 0; i < _devices->devicesCount(); i++)
+		_devices->device(i)->setRoundMode(true);
+	_channels.resize(_devices->devicesCount() * DEVICE_CHANNELS);
+}
+
+QString SyncCaptureClass::channelName(int channel) const
+{
+	int psuChannel = channel % DEVICE_CHANNELS / 2;
+	return QString("psu%0_%1%2").arg(channel / DEVICE_CHANNELS).arg(channel % 2 ? "A" : "V")
+		.arg(psuChannel ? QString::number(psuChannel + 1) : QString());
+}
+
+bool SyncCaptureClass::expected(int channel) const
+{
+	auto device = _devices->device(channel / DEVICE_CHANNELS);
+	auto model = device->model();
+	return device->isUp() && model && channel % DEVICE_CHANNELS / 2 < model->channels;
+}
+
+bool SyncCaptureClass::setExport(QString fileName)
+{
+	_exportFile.setFileName(fileName);
+	if(!_exportFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+		return false;
+	_export.setDevice(&_exportFile);
+	_export << "time_s";
+	for(int i = 0; i < _channels.size(); i++)
+		_export << ',' << channelName(i);
+	_export << '\n';
+	return true;
+}
+
+void SyncCaptureClass::setSeries(QSharedPointer<SeriesClass> series, quint64 origin)
+{
+	_series = series;
+	_origin = origin;
+	_series->setColumns(_channels.size());
+}
+
+void SyncCaptureClass::start(int interval)
+{
+	_interval = interval * 1000000ULL;
+	_timerId = startTimer(interval, Qt::PreciseTimer);
+}
+
+void SyncCaptureClass::timerEvent(QTimerEvent *event)
+{
+	if(event->timerId() != _timerId)
+	{
+		QObject::timerEvent(event);
+		return;
+	}
+	TRACE_SCOPE("gui", "sync round");
+	// the round instant is the common time of all devices requests
+	_instants.append(Log::timestamp());
+	for(int i = 0; i < _devices->devicesCount(); i++)
+		QMetaObject::invokeMethod(_devices->device(i), "startRound", Qt::QueuedConnection);
+	alignRows();
+}
+
+void SyncCaptureClass::addSample(int device, const DeviceClass::Sample &sample)
+{
+	int channel;
+	switch(sample.request)
+	{
+		case ProtocolClass::RequestEnum::VOUT1Q: channel = 0; break;
+		case ProtocolClass::RequestEnum::IOUT1Q: channel = 1; break;
+		case ProtocolClass::RequestEnum::VOUT2Q: channel = 2; break;
+		case ProtocolClass::RequestEnum::IOUT2Q: channel = 3; break;
+		default: return;
+	}
+	channel += device * DEVICE_CHANNELS;
+	if(qIsNaN(sample.value))
+		return;
+	auto &points = _channels[channel];
+	// link delay estimate may drop: keep the order
+	if(!points.isEmpty() && sample.timestamp <= points.last().timestamp)
+		return;
+	points.append({ sample.timestamp, sample.value });
+}
+
+bool SyncCaptureClass::interpolate(int channel, quint64 timestamp, float *value) const
+{
+	auto &points = _channels[channel];
+	int i = 0;
+	while(i < points.size() && points[i].timestamp < timestamp)
+		i++;
+	if(i >= points.size())
+		return false;
+	if(i == 0)
+		// no sample before: the nearest one
+		*value = points[0].value;
+	else
+	{
+		auto &a = points[i - 1], &b = points[i];
+		*value = a.value + (b.value - a.value) * (double)(timestamp - a.timestamp) / (b.timestamp - a.timestamp);
+	}
+	return true;
+}
+
+void SyncCaptureClass::prune(int channel, quint64 timestamp)
+{
+	// keep the last sample before the instant for the next instants
+	auto &points = _channels[channel];
+	int i = 0;
+	while(i + 1 < points.size() && points[i + 1].timestamp < timestamp)
+		i++;
+	points.remove(0, i);
+}
+
+int SyncCaptureClass::alignRows()
+{
+	int ret = 0;
+	auto now = Log::timestamp();
+	while(!_instants.isEmpty())
+	{
+		auto timestamp = _instants.first();
+		bool expired = now - timestamp > ROUND_TIMEOUT * _interval;
+		bool complete = true;
+		QVector<float> values(_channels.size(), NAN);
+		for(int i = 0; i < _channels.size(); i++)
+			// disconnected device & missing PSU channel don't delay others
+			if(!interpolate(i, timestamp, &values[i]) && expected(i))
+				complete = false;
+		if(!complete && !expired)
+			break;
+
+		_instants.removeFirst();
+		_rows++;
+		ret++;
+		if(!complete)
+			_incompleteRows++;
+		for(int i = 0; i < _channels.size(); i++)
+			prune(i, timestamp);
+		if(_exportFile.isOpen())
+		{
+			_export << QString::number(timestamp / 1e9, 'f', 6);
+			foreach(auto value, values)
+				_export << ',' << (qIsNaN(value) ? QString() : QString::number(value, 'f', 3));
+			_export << '\n';
+			// a killed capture keeps the rows
+			_export.flush();
+		}
+		if(_series)
+		{
+			_series->append((qint64)(timestamp - _origin) / 1e9);
+			for(int i = 0; i < values.size(); i++)
+				_series->setLast(i, values[i]);
+		}
+	}
+	return ret;
+}
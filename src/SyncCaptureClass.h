@@ -0,0 +1,82 @@
+#ifndef SyncCaptureClass_H
+#define SyncCaptureClass_H
+
+#include <QObject>
+#include <QVector>
+#include <QFile>
+#include <QTextStream>
+#include <QSharedPointer>
+#include "DeviceManagerClass.h"
+#include "SeriesClass.h"
+
+//! Lockstep acquisition of several PSUs: polling rounds of all devices are started at once,
+//! V & I samples are aligned to the round start instants by linear interpolation
+//! Samples are stamped by the common clock (Log::timestamp()) with per-device link delay compensation
+class SyncCaptureClass : public QObject
+{
+	Q_OBJECT
+
+public:
+	static constexpr int ROUND_TIMEOUT = 4; //!< Instant is aligned with missing channels after N intervals
+	static constexpr int DEVICE_CHANNELS = 4; //!< Channels per device: V & A of PSU channels 1, 2
+
+	//! Switches devices to round mode; create before DeviceManagerClass::start()
+	explicit SyncCaptureClass(DeviceManagerClass *devices, QObject *parent=NULL);
+
+	//! Starts to write aligned rows to CSV file: time & V, A of each device channel
+	bool setExport(QString fileName);
+	//! Appends aligned rows to the series for plotting: a column per channel
+	//! @param origin	Row key origin, Log::timestamp(), ns: keys are seconds since it
+	void setSeries(QSharedPointer<SeriesClass> series, quint64 origin);
+
+	//! Starts rounds
+	//! @param interval	Rounds interval, ms
+	void start(int interval);
+
+	//! Adds the sample taken from the device ring
+	void addSample(int device, const DeviceClass::Sample &sample);
+	//! Exports rows of the instants having samples after them in all channels & appends them to the series
+	//! Row values: by channel; empty if channel has no samples around or PSU has no such channel
+	//! @return Rows aligned
+	int alignRows();
+
+	//! @return Channels count: DEVICE_CHANNELS of each device
+	int channelsCount() const { return _channels.size(); }
+	//! @return Channel name, example: "psu0_V"; PSU channel 2: "psu0_V2"
+	QString channelName(int channel) const;
+
+	quint64 rows() const { return _rows; }
+	//! @return Rows aligned with missing channels since timeout
+	quint64 incompleteRows() const { return _incompleteRows; }
+
+protected:
+	struct Point
+	{
+		quint64 timestamp; //!< ns
+		float value;
+	};
+
+	DeviceManagerClass *_devices;
+	QVector<QVector<Point> > _channels; //!< Recent samples by channel: device * DEVICE_CHANNELS + PSU channel * 2 + (0 - V; 1 - A)
+	QVector<quint64> _instants; //!< Not aligned round start instants, ns
+	quint64 _interval = 0; //!< ns
+	int _timerId = -1; //!< Rounds timer ID: -1 - timer not launched; 0..
+	QFile _exportFile;
+	QTextStream _export;
+	QSharedPointer<SeriesClass> _series; //!< Plotted rows: nullptr - not plotted
+	quint64 _origin = 0; //!< Series keys origin, ns
+	quint64 _rows = 0;
+	quint64 _incompleteRows = 0;
+
+	void timerEvent(QTimerEvent *event) override;
+
+	//! Interpolates the channel at the instant
+	//! @return false if the channel has no samples after the instant yet
+	bool interpolate(int channel, quint64 timestamp, float *value) const;
+	//! Discards channel samples not needed to interpolate at the instant
+	void prune(int channel, quint64 timestamp);
+	//! @return The channel samples are expected: device is up & model has the PSU channel
+	bool expected(int channel) const;
+};
+
+#endif // SyncCaptureClass_H
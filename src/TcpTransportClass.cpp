@@ -0,0 +1,156 @@
+#include <QUrl>
+#include <QUrlQuery>
+#include <QTimerEvent>
+#include "TcpTransportClass.h"
+
+constexpr int TcpTransportClass::DEFAULT_LATENCY_BUDGET;
+constexpr int TcpTransportClass::CONNECT_TIMEOUT;
+
+TcpTransportClass::TcpTransportClass(QObject *parent) :
+	TransportClass(parent), _socket(this)
+{
+	_latencyBudget = DEFAULT_LATENCY_BUDGET;
+	connect(&_socket, SIGNAL(connected()), SLOT(_socket_connected()));
+	connect(&_socket, SIGNAL(readyRead()), SIGNAL(readyRead()));
+	connect(&_socket, SIGNAL(error(QAbstractSocket::SocketError)),
+		SLOT(_socket_error(QAbstractSocket::SocketError)));
+	connect(&_socket, SIGNAL(disconnected()), SLOT(_socket_disconnected()));
+}
+
+bool TcpTransportClass::open(QString portName)
+{
+	close();
+	_portName = portName;
+	QUrl url(portName);
+	if(!url.isValid() || url.host().isEmpty() || url.port() <= 0)
+	{
+		_error = QString("invalid address, expected tcp://host:port");
+		return false;
+	}
+	QUrlQuery query(url);
+	_latencyBudget = query.hasQueryItem("budget") ? query.queryItemValue("budget").toInt() : DEFAULT_LATENCY_BUDGET;
+
+	// the protocol thread isn't blocked: completed by connected() or failed by error() or the timeout
+	_error.clear();
+	_socket.connectToHost(url.host(), url.port());
+	_connectTimerId = startTimer(CONNECT_TIMEOUT);
+	return true;
+}
+
+void TcpTransportClass::_socket_connected()
+{
+	stopConnectTimer();
+	// request & answer are few bytes: don't wait for ACK of the previous segment
+	_socket.setSocketOption(QAbstractSocket::LowDelayOption, 1);
+	_socket.setSocketOption(QAbstractSocket::KeepAliveOption, 1);
+	emit opened();
+}
+
+void TcpTransportClass::timerEvent(QTimerEvent *event)
+{
+	if(event->timerId() != _connectTimerId)
+	{
+		TransportClass::timerEvent(event);
+		return;
+	}
+	stopConnectTimer();
+	_socket.blockSignals(true);
+	_socket.abort();
+	_socket.blockSignals(false);
+	fail(QString("connection timeout"));
+}
+
+void TcpTransportClass::stopConnectTimer()
+{
+	if(_connectTimerId >= 0)
+		killTimer(_connectTimerId);
+	_connectTimerId = -1;
+}
+
+void TcpTransportClass::close()
+{
+	stopConnectTimer();
+	_writeBuffer.clear();
+	_socket.blockSignals(true);
+	_socket.abort();
+	_socket.blockSignals(false);
+}
+
+bool TcpTransportClass::isOpen() const
+{
+	return _socket.state() == QAbstractSocket::ConnectedState;
+}
+
+qint64 TcpTransportClass::read(char *data, qint64 maxLength)
+{
+	if(!isOpen())
+		return -1;
+	return qMax<qint64>(_socket.read(data, maxLength), 0);
+}
+
+void TcpTransportClass::write(const QByteArray &data)
+{
+	if(!isOpen())
+		return;
+	if(_flushQueued)
+	{
+		// back-to-back write
+		_writeBuffer += data;
+		return;
+	}
+	// nothing is pending: the request timer starts at the actual send
+	_socket.write(data);
+	_socket.flush();
+	_flushQueued = true;
+	QMetaObject::invokeMethod(this, "_flush", Qt::QueuedConnection);
+}
+
+void TcpTransportClass::_flush()
+{
+	_flushQueued = false;
+	flush();
+}
+
+void TcpTransportClass::flush()
+{
+	if(_writeBuffer.isEmpty() || !isOpen())
+		return;
+	_socket.write(_writeBuffer);
+	_writeBuffer.clear();
+	_socket.flush();
+}
+
+void TcpTransportClass::clear()
+{
+	_writeBuffer.clear();
+	if(isOpen())
+		_socket.readAll();
+}
+
+QString TcpTransportClass::description() const
+{
+	return QString("%1:%2 budget %3 ms").arg(_socket.peerAddress().toString()).arg(_socket.peerPort())
+		.arg(_latencyBudget);
+}
+
+void TcpTransportClass::fail(QString error)
+{
+	// remote close emits both error & disconnected
+	if(!_error.isEmpty())
+		return;
+	_error = error;
+	stopConnectTimer();
+	_writeBuffer.clear();
+	emit errorOccurred(error);
+}
+
+void TcpTransportClass::_socket_error(QAbstractSocket::SocketError error)
+{
+	Q_UNUSED(error)
+	fail(_socket.errorString());
+}
+
+void TcpTransportClass::_socket_disconnected()
+{
+	fail(QString("connection closed by peer"));
+}
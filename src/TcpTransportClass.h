@@ -0,0 +1,57 @@
+#ifndef TcpTransportClass_H
+#define TcpTransportClass_H
+
+#include <QTcpSocket>
+#include "TransportClass.h"
+
+//! Serial-over-IP transport: TCP connection to terminal server (example: ser2net) or PSU LAN port
+//! Nagle algorithm is disabled; a write is sent at once, the writes following it in the same event loop pass
+//! are batched to one segment
+class TcpTransportClass : public TransportClass
+{
+	Q_OBJECT
+
+public:
+	static constexpr int DEFAULT_LATENCY_BUDGET = 50; //!< Network round trip, ms
+	static constexpr int CONNECT_TIMEOUT = 2000; //!< Connection in progress fails after, ms
+
+	explicit TcpTransportClass(QObject *parent=NULL);
+
+	TypeEnum type() const override { return TypeEnum::Tcp; }
+
+	//! Starts to connect: opened() or errorOccurred() follows
+	//! @param portName	"tcp://host:port[?budget=ms]", example: tcp://192.168.1.10:4001?budget=20
+	//! @return false - invalid address
+	bool open(QString portName) override;
+	void close() override;
+	bool isOpen() const override;
+
+	qint64 read(char *data, qint64 maxLength) override;
+	//! Sends data at once if nothing is written in this event loop pass,
+	//! otherwise appends data to the batch sent on the next pass
+	void write(const QByteArray &data) override;
+	void flush() override;
+	void clear() override;
+
+	QString errorString() const override { return _error; }
+	QString description() const override;
+
+protected slots:
+	void _socket_connected();
+	void _socket_error(QAbstractSocket::SocketError error);
+	void _socket_disconnected();
+	void _flush();
+
+protected:
+	QTcpSocket _socket;
+	QString _error;
+	QByteArray _writeBuffer; //!< Batched data
+	bool _flushQueued = false; //!< Written in this event loop pass: the following writes are batched
+	int _connectTimerId = -1; //!< Connection timeout timer ID: -1 - timer not launched; 0..
+
+	void timerEvent(QTimerEvent *event) override;
+	void stopConnectTimer();
+	void fail(QString error);
+};
+
+#endif // TcpTransportClass_H
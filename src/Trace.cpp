@@ -0,0 +1,147 @@
+#include <mutex>
+#include <QFile>
+#include "Log.h"
+#include "Trace.h"
+
+static constexpr int FLUSH_SIZE = 1 << 16; //!< Events are written to file by blocks, bytes
+
+std::atomic<bool> Trace::_enabled { false };
+
+static std::mutex _mutex; //!< Protects the file & buffer
+static QFile _file;
+static QByteArray _buffer; //!< Events not written yet
+static bool _first = true; //!< No event is written yet
+static std::atomic<int> _threadsCount { 0 };
+
+//! The longest span completed on the thread
+struct LongestSpan
+{
+	const char *name = nullptr;
+	quint64 duration = 0; //!< ns
+};
+static thread_local LongestSpan _longest;
+
+//! @return Calling thread track id: 1..
+static int _tid()
+{
+	thread_local int tid = ++_threadsCount;
+	return tid;
+}
+
+static QByteArray _escape(QString s)
+{
+	return s.replace('\\', "\\\\").replace('"', "\\\"").toUtf8();
+}
+
+//! @return Trace event common members
+static QByteArray _event(char phase, const char *category, const char *name, quint64 timestamp)
+{
+	return QByteArray("{\"ph\":\"") + phase + "\",\"cat\":\"" + category + "\",\"name\":\"" + name
+		+ "\",\"pid\":1,\"tid\":" + QByteArray::number(_tid())
+		+ ",\"ts\":" + QByteArray::number(timestamp / 1000., 'f', 3);
+}
+
+bool Trace::setFile(QString fileName)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_file.setFileName(fileName);
+	if(!_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+	_file.write("[\n");
+	_first = true;
+	_enabled.store(true, std::memory_order_relaxed);
+	return true;
+}
+
+void Trace::close()
+{
+	_enabled.store(false, std::memory_order_relaxed);
+	std::lock_guard<std::mutex> lock(_mutex);
+	if(!_file.isOpen())
+		return;
+	_file.write(_buffer);
+	_buffer.clear();
+	_file.write("\n]\n");
+	_file.close();
+}
+
+quint64 Trace::now()
+{
+	return Log::timestamp() | 1;
+}
+
+void Trace::record(const QByteArray &event)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if(!_first)
+		_buffer += ",\n";
+	_first = false;
+	_buffer += event;
+	if(_buffer.length() >= FLUSH_SIZE)
+	{
+		_file.write(_buffer);
+		_buffer.clear();
+	}
+}
+
+void Trace::setThreadName(QString name)
+{
+	if(!enabled())
+		return;
+	// once per thread
+	thread_local QString threadName;
+	if(threadName == name)
+		return;
+	threadName = name;
+	record(QByteArray("{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":") + QByteArray::number(_tid())
+		+ ",\"args\":{\"name\":\"" + _escape(name) + "\"}}");
+}
+
+void Trace::complete(const char *category, const char *name, quint64 start, const QByteArray &args)
+{
+	if(!enabled())
+		return;
+	auto duration = now() - start;
+	if(duration > _longest.duration)
+	{
+		_longest.name = name;
+		_longest.duration = duration;
+	}
+	auto event = _event('X', category, name, start) + ",\"dur\":" + QByteArray::number(duration / 1000., 'f', 3);
+	if(!args.isEmpty())
+		event += ",\"args\":{" + args + '}';
+	record(event + '}');
+}
+
+void Trace::asyncBegin(const char *category, const char *name, quint64 id)
+{
+	if(!enabled())
+		return;
+	record(_event('b', category, name, now()) + ",\"id\":" + QByteArray::number(id) + '}');
+}
+
+void Trace::asyncEnd(const char *category, const char *name, quint64 id, const QByteArray &args)
+{
+	if(!enabled())
+		return;
+	auto event = _event('e', category, name, now()) + ",\"id\":" + QByteArray::number(id);
+	if(!args.isEmpty())
+		event += ",\"args\":{" + args + '}';
+	record(event + '}');
+}
+
+QString Trace::takeLongestSpan()
+{
+	auto longest = _longest;
+	_longest = LongestSpan();
+	if(!longest.name)
+		return QString();
+	return QString("%0 %1 ms").arg(longest.name).arg(longest.duration / 1e6, 0, 'f', 1);
+}
+
+void Trace::instant(const char *category, const char *name)
+{
+	if(!enabled())
+		return;
+	record(_event('i', category, name, now()) + ",\"s\":\"t\"}");
+}
@@ -0,0 +1,79 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <QString>
+#include <QByteArray>
+
+//! Chrome/Perfetto trace-event JSON writer
+//! Spans are recorded on per-thread tracks; when tracing is not started, calls cost one relaxed load
+class Trace
+{
+public:
+	//! @return Whether tracing is started
+	static bool enabled()
+	{
+		return _enabled.load(std::memory_order_relaxed);
+	}
+
+	//! Starts to write trace events to file
+	static bool setFile(QString fileName);
+
+	//! Writes pending events & closes the file
+	static void close();
+
+	//! Names the calling thread track; repeated calls with the same name are ignored
+	static void setThreadName(QString name);
+
+	//! Complete event: span on the calling thread track
+	//! @param start	Log::timestamp(), ns
+	//! @param args	JSON object members, example: "\"bytes\":5"
+	static void complete(const char *category, const char *name, quint64 start, const QByteArray &args = QByteArray());
+
+	//! Async span begin/end: spans crossing event handlers, example: request & answer
+	static void asyncBegin(const char *category, const char *name, quint64 id);
+	static void asyncEnd(const char *category, const char *name, quint64 id, const QByteArray &args = QByteArray());
+
+	//! @return The longest span completed on the calling thread since the last call, example: "replot 120.5 ms";
+	//! empty if tracing is not started
+	static QString takeLongestSpan();
+
+	//! Instant event on the calling thread track
+	static void instant(const char *category, const char *name);
+
+	//! Records the scope as complete event
+	class ScopeClass
+	{
+	public:
+		ScopeClass(const char *category, const char *name) :
+			_category(category), _name(name), _start(enabled() ? now() : 0)
+		{
+		}
+
+		~ScopeClass()
+		{
+			if(_start)
+				complete(_category, _name, _start);
+		}
+
+	protected:
+		const char *_category;
+		const char *_name;
+		const quint64 _start; //!< ns: 0 - tracing is not started
+	};
+
+	//! @return Log::timestamp(), ns; never 0
+	static quint64 now();
+
+protected:
+	static std::atomic<bool> _enabled;
+
+	static void record(const QByteArray &event);
+};
+
+#define _TRACE_CONCAT2(a, b) a##b
+#define _TRACE_CONCAT(a, b) _TRACE_CONCAT2(a, b)
+//! Records the rest of the block as span
+#define TRACE_SCOPE(category, name) Trace::ScopeClass _TRACE_CONCAT(_traceScope, __LINE__)(category, name)
+
+#endif // TRACE_H
@@ -0,0 +1,53 @@
+#include "TransportClass.h"
+#include "SerialTransportClass.h"
+#include "NativeSerialPortClass.h"
+#include "TcpTransportClass.h"
+
+TransportClass::TypeEnum TransportClass::typeOf(QString portName, bool native)
+{
+	if(portName.startsWith("tcp://"))
+		return TypeEnum::Tcp;
+	return native ? TypeEnum::NativeSerial : TypeEnum::Serial;
+}
+
+TransportClass *TransportClass::create(TypeEnum type, QObject *parent)
+{
+	switch(type)
+	{
+		case TypeEnum::NativeSerial: return new NativeSerialPortClass(parent);
+		case TypeEnum::Tcp: return new TcpTransportClass(parent);
+		default: return new SerialTransportClass(parent);
+	}
+}
+
+void TransportClass::setSerialParameters(int baud, QSerialPort::DataBits dataBits, QSerialPort::Parity parity,
+	QSerialPort::StopBits stopBits)
+{
+	_baud = baud;
+	_dataBits = dataBits;
+	_parity = parity;
+	_stopBits = stopBits;
+}
+
+QString TransportClass::serialParameters() const
+{
+	QLatin1Char parity(' ');
+	switch(_parity)
+	{
+		case QSerialPort::NoParity: parity = QLatin1Char('N'); break;
+		case QSerialPort::EvenParity: parity = QLatin1Char('E'); break;
+		case QSerialPort::OddParity: parity = QLatin1Char('O'); break;
+		case QSerialPort::SpaceParity: parity = QLatin1Char('S'); break;
+		case QSerialPort::MarkParity: parity = QLatin1Char('M'); break;
+		default: break;
+	}
+	QString stopBits(" ");
+	switch(_stopBits)
+	{
+		case QSerialPort::OneStop: stopBits = "1"; break;
+		case QSerialPort::OneAndHalfStop: stopBits = "1.5"; break;
+		case QSerialPort::TwoStop: stopBits = "2"; break;
+		default: break;
+	}
+	return QString("%1 %2%3%4").arg(_baud).arg(_dataBits).arg(parity).arg(stopBits);
+}
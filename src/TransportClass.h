@@ -0,0 +1,82 @@
+#ifndef TransportClass_H
+#define TransportClass_H
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QSerialPort>
+
+//! Byte stream to PSU: serial port (QSerialPort), native serial port (termios, also ptys) or TCP connection
+//! Transports are created once & reopened by reconnects
+class TransportClass : public QObject
+{
+	Q_OBJECT
+
+public:
+	enum class TypeEnum
+	{
+		Serial, //!< QSerialPort
+		NativeSerial, //!< Raw file descriptor with termios (Linux): serial ports & ptys
+		Tcp, //!< Serial-over-IP terminal server or PSU LAN port: "tcp://host:port"
+	};
+
+	explicit TransportClass(QObject *parent=NULL) : QObject(parent) {}
+
+	//! @return Transport type for port name: "tcp://" prefix - TCP; others - serial
+	//! @param native	Native serial transport for serial ports
+	static TypeEnum typeOf(QString portName, bool native);
+	static TransportClass *create(TypeEnum type, QObject *parent);
+
+	virtual TypeEnum type() const = 0;
+
+	//! Sets serial line parameters for the next open; ignored by TCP
+	void setSerialParameters(int baud, QSerialPort::DataBits dataBits, QSerialPort::Parity parity,
+		QSerialPort::StopBits stopBits);
+
+	//! @param portName	Example: ttyACM0; /dev/pts/3; tcp://192.168.1.10:4001
+	//! @return false - open failed; true - opened, or open is in progress if isOpen() is false:
+	//! opened() or errorOccurred() follows
+	virtual bool open(QString portName) = 0;
+	virtual void close() = 0;
+	virtual bool isOpen() const = 0;
+
+	//! Reads available bytes
+	//! @return Read bytes count: 0 - no bytes available; -1 - transport is failed
+	virtual qint64 read(char *data, qint64 maxLength) = 0;
+	//! Writes data; may be batched with the following writes until flush() or the event loop
+	virtual void write(const QByteArray &data) = 0;
+	//! Sends batched data
+	virtual void flush() {}
+	//! Discards not read & not sent data
+	virtual void clear() = 0;
+
+	QString portName() const { return _portName; }
+	//! @return Last error: empty - no error
+	virtual QString errorString() const = 0;
+	//! @return Opened transport parameters for log, example: "9600 8N1"
+	virtual QString description() const = 0;
+
+	//! @return Answer timeout extension for the transport round trip, ms
+	int latencyBudget() const { return _latencyBudget; }
+
+signals:
+	//! Open in progress is complete, example: TCP connection established
+	void opened();
+	void readyRead();
+	//! Transport is failed while opened or opening, example: device unplugged, connection lost or refused
+	void errorOccurred(QString error);
+
+protected:
+	QString _portName;
+	int _latencyBudget = 0; //!< ms
+
+	int _baud = 9600;
+	QSerialPort::DataBits _dataBits = QSerialPort::Data8;
+	QSerialPort::Parity _parity = QSerialPort::NoParity;
+	QSerialPort::StopBits _stopBits = QSerialPort::OneStop;
+
+	//! @return Serial line parameters, example: "9600 8N1"
+	QString serialParameters() const;
+};
+
+#endif // TransportClass_H
@@ -0,0 +1,57 @@
+#include <QSocketNotifier>
+#include "UnixSignalClass.h"
+
+#ifdef Q_OS_UNIX
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#endif
+
+int UnixSignalClass::_sockets[2] = { -1, -1 };
+
+UnixSignalClass::UnixSignalClass(QObject *parent) :
+	QObject(parent)
+{
+#ifdef Q_OS_UNIX
+	if(_sockets[0] < 0 && ::socketpair(AF_UNIX, SOCK_STREAM, 0, _sockets))
+		return;
+	_notifier = new QSocketNotifier(_sockets[1], QSocketNotifier::Read, this);
+	connect(_notifier, SIGNAL(activated(int)), SLOT(_notifier_activated()));
+#endif
+}
+
+bool UnixSignalClass::handle(int signal)
+{
+#ifdef Q_OS_UNIX
+	if(!_notifier)
+		return false;
+	struct sigaction action = {};
+	action.sa_handler = signalHandler;
+	sigemptyset(&action.sa_mask);
+	action.sa_flags = SA_RESTART;
+	return !::sigaction(signal, &action, nullptr);
+#else
+	Q_UNUSED(signal)
+	return false;
+#endif
+}
+
+void UnixSignalClass::signalHandler(int signal)
+{
+#ifdef Q_OS_UNIX
+	// async-signal-safe: only write
+	unsigned char ch = signal;
+	if(::write(_sockets[0], &ch, sizeof(ch))) {}
+#else
+	Q_UNUSED(signal)
+#endif
+}
+
+void UnixSignalClass::_notifier_activated()
+{
+#ifdef Q_OS_UNIX
+	unsigned char ch;
+	if(::read(_sockets[1], &ch, sizeof(ch)) == sizeof(ch))
+		emit signalled(ch);
+#endif
+}
@@ -0,0 +1,34 @@
+#ifndef UnixSignalClass_H
+#define UnixSignalClass_H
+
+#include <QObject>
+
+class QSocketNotifier;
+
+//! Delivers Unix signals (example: SIGUSR1) to the event loop as Qt signal
+//! The signal handler only writes the signal number to the socket pair
+class UnixSignalClass : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit UnixSignalClass(QObject *parent=NULL);
+
+	//! Starts to handle the Unix signal
+	bool handle(int signal);
+
+signals:
+	void signalled(int signal);
+
+protected slots:
+	void _notifier_activated();
+
+protected:
+	static int _sockets[2]; //!< Socket pair: 0 - written by signal handler; 1 - read by notifier
+
+	QSocketNotifier *_notifier = nullptr;
+
+	static void signalHandler(int signal);
+};
+
+#endif // UnixSignalClass_H
@@ -0,0 +1,146 @@
+#include <QCoreApplication>
+#include <QTimerEvent>
+#include "WatchdogClass.h"
+#include "Log.h"
+#include "Trace.h"
+
+const QEvent::Type WatchdogClass::HeartbeatEvent::TYPE = (QEvent::Type)QEvent::registerEventType();
+
+WatchdogClass::WatchdogClass(QObject *parent) :
+	QObject(parent)
+{
+}
+
+WatchdogClass::~WatchdogClass()
+{
+	// timers can't be stopped from another thread
+	if(_thread.isRunning())
+		QMetaObject::invokeMethod(this, "_stop", Qt::BlockingQueuedConnection);
+	_thread.quit();
+	_thread.wait();
+	foreach(auto watched, _watched)
+	{
+		auto thread = watched->thread.data();
+		if(!thread || thread == QThread::currentThread() || !thread->isRunning())
+			// no event loop to delete it later
+			delete watched->probe;
+		else
+		{
+			// probe is deleted by it's thread
+			QCoreApplication::removePostedEvents(watched->probe, HeartbeatEvent::TYPE);
+			watched->probe->deleteLater();
+		}
+		delete watched;
+	}
+}
+
+void WatchdogClass::watch(QString name, QThread *thread)
+{
+	auto watched = new WatchedThread;
+	watched->name = name;
+	watched->thread = thread;
+	watched->probe = new ProbeClass(this, watched);
+	watched->probe->moveToThread(thread);
+	_watched.append(watched);
+}
+
+void WatchdogClass::start(int interval, int threshold)
+{
+	_threshold = threshold * 1000000ULL;
+	moveToThread(&_thread);
+	_thread.start();
+	QMetaObject::invokeMethod(this, "_startTimer", Qt::QueuedConnection, Q_ARG(int, interval));
+}
+
+void WatchdogClass::_startTimer(int interval)
+{
+	Trace::setThreadName("watchdog");
+	_timerId = startTimer(interval, Qt::PreciseTimer);
+}
+
+void WatchdogClass::_stop()
+{
+	if(_timerId >= 0)
+	{
+		killTimer(_timerId);
+		_timerId = -1;
+	}
+	moveToThread(_thread.thread());
+}
+
+void WatchdogClass::timerEvent(QTimerEvent *event)
+{
+	if(event->timerId() != _timerId)
+	{
+		QObject::timerEvent(event);
+		return;
+	}
+	auto now = Trace::now();
+	foreach(auto watched, _watched)
+	{
+		auto posted = watched->posted.load(std::memory_order_acquire);
+		if(!posted)
+		{
+			// previous heartbeat is dispatched: post the next one
+			// normal priority: the heartbeat waits behind the queued events it measures
+			watched->blockedWarned = false;
+			watched->posted.store(now, std::memory_order_release);
+			QCoreApplication::postEvent(watched->probe, new HeartbeatEvent(now));
+		}
+		else if(!watched->blockedWarned && now - posted > _threshold)
+		{
+			// the thread doesn't dispatch events
+			watched->blockedWarned = true;
+			LOG_WARNING(Watchdog, QString("watchdog: %0 thread is blocked for %1 ms")
+				.arg(watched->name).arg((now - posted) / 1000000));
+		}
+	}
+}
+
+bool WatchdogClass::ProbeClass::event(QEvent *event)
+{
+	if(event->type() != HeartbeatEvent::TYPE)
+		return QObject::event(event);
+	_watchdog->heartbeat(_watched, static_cast<HeartbeatEvent *>(event)->posted);
+	return true;
+}
+
+void WatchdogClass::heartbeat(WatchedThread *watched, quint64 posted)
+{
+	auto lag = Trace::now() - posted;
+	{
+		QMutexLocker locker(&_mutex);
+		watched->lag.record(lag / 1000);
+	}
+	// the span blocking the thread is completed before the heartbeat dispatch
+	auto span = Trace::takeLongestSpan();
+	if(lag > _threshold)
+	{
+		Trace::complete("watchdog", "lag", posted);
+		// the lag span itself is not a cause of the next lag
+		Trace::takeLongestSpan();
+		LOG_WARNING_RATE_LIMITED(Watchdog, watched, 1000, QString("watchdog: %0 thread lag %1 ms%2")
+			.arg(watched->name).arg(lag / 1e6, 0, 'f', 1)
+			.arg(span.isEmpty() ? QString() : QString("; longest span: ") + span));
+	}
+	watched->posted.store(0, std::memory_order_release);
+}
+
+QVector<QPair<QString, HistogramClass> > WatchdogClass::histograms() const
+{
+	QVector<QPair<QString, HistogramClass> > ret;
+	QMutexLocker locker(&_mutex);
+	foreach(auto watched, _watched)
+		ret.append(qMakePair(watched->name, watched->lag));
+	return ret;
+}
+
+QString WatchdogClass::toText() const
+{
+	QString ret;
+	foreach(auto &h, histograms())
+		ret += QString("lag %0: count %1 p50 %2 p99 %3 max %4 us\n")
+			.arg(h.first).arg(h.second.count()).arg(h.second.quantile(0.5))
+			.arg(h.second.quantile(0.99)).arg(h.second.max());
+	return ret;
+}
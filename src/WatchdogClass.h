@@ -0,0 +1,96 @@
+#ifndef WatchdogClass_H
+#define WatchdogClass_H
+
+#include <atomic>
+#include <QObject>
+#include <QThread>
+#include <QPointer>
+#include <QMutex>
+#include <QVector>
+#include <QEvent>
+#include "StatisticsClass.h"
+
+//! Measures event loops dispatch lag of watched threads
+//! Own thread posts heartbeat events to each watched thread; the lag between post & dispatch
+//! is recorded to histogram & warned about when it exceeds the threshold
+//! Must not have parent since it's moved to own thread
+class WatchdogClass : public QObject
+{
+	Q_OBJECT
+
+public:
+	static constexpr int DEFAULT_INTERVAL = 100; //!< Heartbeat interval, ms
+	static constexpr int DEFAULT_THRESHOLD = 100; //!< Lag warning threshold, ms
+
+	explicit WatchdogClass(QObject *parent=NULL);
+	~WatchdogClass();
+
+	//! Starts to watch the thread; call before start()
+	//! Watched threads other than the destructor one are expected to be stopped or deleted before the destructor
+	void watch(QString name, QThread *thread);
+
+	//! Starts heartbeats
+	//! @param interval	ms
+	//! @param threshold	ms
+	void start(int interval = DEFAULT_INTERVAL, int threshold = DEFAULT_THRESHOLD);
+
+	//! @return Lag histograms snapshot by thread name, us; thread-safe
+	QVector<QPair<QString, HistogramClass> > histograms() const;
+
+	QString toText() const;
+
+protected:
+	//! Heartbeat posted to the watched thread
+	class HeartbeatEvent : public QEvent
+	{
+	public:
+		static const QEvent::Type TYPE;
+
+		explicit HeartbeatEvent(quint64 posted) : QEvent(TYPE), posted(posted) {}
+
+		const quint64 posted; //!< Trace::now(), ns
+	};
+
+	struct WatchedThread;
+
+	//! Receives heartbeats in the watched thread
+	class ProbeClass : public QObject
+	{
+	public:
+		ProbeClass(WatchdogClass *watchdog, WatchedThread *watched) : _watchdog(watchdog), _watched(watched) {}
+
+		bool event(QEvent *event) override;
+
+	protected:
+		WatchdogClass *_watchdog;
+		WatchedThread *_watched;
+	};
+
+	struct WatchedThread
+	{
+		QString name;
+		QPointer<QThread> thread; //!< nullptr - the thread is deleted
+		ProbeClass *probe = nullptr;
+		std::atomic<quint64> posted { 0 }; //!< Pending heartbeat post time, ns: 0 - no heartbeat pending
+		bool blockedWarned = false; //!< Blocked thread is warned for the pending heartbeat
+		HistogramClass lag; //!< us; protected by _mutex
+	};
+
+	QThread _thread; //!< Heartbeats are posted from
+	mutable QMutex _mutex; //!< Protects histograms
+	QVector<WatchedThread *> _watched;
+	quint64 _threshold = DEFAULT_THRESHOLD * 1000000ULL; //!< ns
+	int _timerId = -1; //!< Heartbeat timer ID: -1 - timer not launched; 0..
+
+	void timerEvent(QTimerEvent *event) override;
+
+	//! Records the heartbeat lag; called in the watched thread
+	void heartbeat(WatchedThread *watched, quint64 posted);
+
+protected slots:
+	void _startTimer(int interval);
+	//! Kills the heartbeat timer in own thread & moves to the thread of the owner
+	void _stop();
+};
+
+#endif // WatchdogClass_H
@@ -0,0 +1,67 @@
+#include <string.h>
+#include "WireTraceClass.h"
+
+constexpr char WireTraceClass::MAGIC[8];
+
+bool WireTraceClass::openWrite(QString fileName)
+{
+	close();
+	_file.setFileName(fileName);
+	if(!_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+	_stream.setDevice(&_file);
+	_stream.writeRawData(MAGIC, sizeof(MAGIC));
+	_timer.start();
+	return true;
+}
+
+void WireTraceClass::writeRecord(DirectionEnum direction, const char *data, int length, quint64 timestamp)
+{
+	// split to records with 16 bit length
+	int pos = 0;
+	do
+	{
+		auto recordLength = qMin(length - pos, 0xFFFF);
+		_stream << timestamp << (quint8)direction << (quint16)recordLength;
+		_stream.writeRawData(data + pos, recordLength);
+		pos += recordLength;
+	} while(pos < length);
+}
+
+bool WireTraceClass::read(QString fileName)
+{
+	close();
+	records.clear();
+	QFile file(fileName);
+	if(!file.open(QIODevice::ReadOnly))
+		return false;
+	QDataStream stream(&file);
+
+	char magic[sizeof(MAGIC)];
+	if(stream.readRawData(magic, sizeof(magic)) != sizeof(magic) || memcmp(magic, MAGIC, sizeof(magic)))
+		return false;
+
+	while(!stream.atEnd())
+	{
+		Record r;
+		quint8 direction;
+		quint16 length;
+		stream >> r.timestamp >> direction >> length;
+		r.direction = (DirectionEnum)direction;
+		r.data.resize(length);
+		if(stream.readRawData(r.data.data(), length) != length || stream.status() != QDataStream::Ok)
+			// truncated file
+			break;
+		records.append(r);
+	}
+	return true;
+}
+
+void WireTraceClass::close()
+{
+	if(_file.isOpen())
+	{
+		_stream.setDevice(nullptr);
+		_file.close();
+	}
+}
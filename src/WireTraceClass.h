@@ -0,0 +1,80 @@
+#ifndef WireTraceClass_H
+#define WireTraceClass_H
+
+#include <QByteArray>
+#include <QVector>
+#include <QFile>
+#include <QDataStream>
+#include <QElapsedTimer>
+
+//! Raw serial port wire trace: compact binary file of timestamped bytes read & written
+//! Record: monotonic timestamp (ns), direction, length, bytes
+class WireTraceClass
+{
+public:
+	enum class DirectionEnum : quint8
+	{
+		RX, //!< Bytes read from port
+		TX, //!< Bytes written to port
+		Open, //!< Port opened, bytes: port name
+		Probe, //!< Candidate port probed, bytes: port name; followed by the probe ProbeTX & ProbeRX records
+		ProbeTX, //!< Probe request written
+		ProbeRX, //!< Probe answer bytes read
+	};
+
+	struct Record
+	{
+		quint64 timestamp; //!< Since capture start, ns
+		DirectionEnum direction;
+		QByteArray data;
+	};
+
+	//! Starts capture to file
+	bool openWrite(QString fileName);
+
+	//! Appends record to capture file, if capture started
+	void write(DirectionEnum direction, const QByteArray &data)
+	{
+		if(_file.isOpen())
+			writeRecord(direction, data.constData(), data.length());
+	}
+	void write(DirectionEnum direction, const char *data, int length)
+	{
+		if(_file.isOpen())
+			writeRecord(direction, data, length);
+	}
+	//! Appends record with the timestamp taken before, e.g. by another thread
+	void write(const Record &record)
+	{
+		if(_file.isOpen())
+			writeRecord(record.direction, record.data.constData(), record.data.length(), record.timestamp);
+	}
+
+	//! @return Current timestamp, ns; thread safe
+	quint64 timestamp() const { return (quint64)_timer.nsecsElapsed(); }
+
+	bool isWriting() const { return _file.isOpen(); }
+
+	//! Reads trace file to records
+	//! @return false if file can't be read or has wrong format
+	bool read(QString fileName);
+
+	void close();
+
+	QVector<Record> records; //!< Read trace records
+
+protected:
+	static constexpr char MAGIC[8] = { 'K', 'P', 'S', 'U', 'W', 'I', 'R', '1' }; //!< File signature
+
+	QFile _file; //!< Capture file
+	QDataStream _stream;
+	QElapsedTimer _timer; //!< Monotonic timestamps source
+
+	void writeRecord(DirectionEnum direction, const char *data, int length)
+	{
+		writeRecord(direction, data, length, timestamp());
+	}
+	void writeRecord(DirectionEnum direction, const char *data, int length, quint64 timestamp);
+};
+
+#endif // WireTraceClass_H
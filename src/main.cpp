@@ -1,7 +1,10 @@
 #include <iostream>
 #include <QDateTime>
 #include <QApplication>
+#include <QCommandLineParser>
 #include "mainwindow.h"
+#include "Log.h"
+#include "Trace.h"
 
 int main(int argc, char *argv[])
 {
@@ -9,8 +12,170 @@ int main(int argc, char *argv[])
 
 	QApplication a(argc, argv);
 
-	MainWindow w;
-	w.show();
+	QCommandLineParser parser;
+	parser.addHelpOption();
+	QCommandLineOption logBinaryOption("log-binary", "Write binary log to <file>, in addition to stdout.", "file");
+	parser.addOption(logBinaryOption);
+	QCommandLineOption decodeLogOption("decode-log", "Decode binary log <file> to stdout and exit.", "file");
+	parser.addOption(decodeLogOption);
+	QCommandLineOption logLevelOption("log-level",
+		"Minimum log <levels> per category, example: data=none,gui=warning. "
+		"Categories: serial, protocol, data, gui. Levels: debug, info, warning, error, none.", "levels");
+	parser.addOption(logLevelOption);
+	QCommandLineOption captureOption("capture", "Capture bytes read & written by serial port to wire trace <file>.", "file");
+	parser.addOption(captureOption);
+	QCommandLineOption replayOption("replay", "Replay wire trace <file> instead of serial port.", "file");
+	parser.addOption(replayOption);
+	QCommandLineOption replayFastOption("replay-fast", "Replay as fast as possible instead of original timing.");
+	parser.addOption(replayFastOption);
+	QCommandLineOption statsFileOption("stats-file", "Append protocol statistics to <file> on SIGUSR1 or periodically.", "file");
+	parser.addOption(statsFileOption);
+	QCommandLineOption statsIntervalOption("stats-interval", "Write statistics every <seconds>.", "seconds");
+	parser.addOption(statsIntervalOption);
+	QCommandLineOption metricsOption("metrics", "Serve Prometheus metrics on <address>: [<host>:]<port> or unix:<path>.", "address");
+	parser.addOption(metricsOption);
+	QCommandLineOption traceOption("trace", "Write Chrome/Perfetto trace events JSON to <file>.", "file");
+	parser.addOption(traceOption);
+	QCommandLineOption lagThresholdOption("lag-threshold", "Warn when GUI or protocol event loop lags more than <ms>.", "ms");
+	parser.addOption(lagThresholdOption);
+	QCommandLineOption serialNumberOption("sn", "Connect to the PSU with serial number <sn> only; repeat for several devices.", "sn");
+	parser.addOption(serialNumberOption);
+	QCommandLineOption portOption("port", "Open serial port <port> instead of search by USB VID:PID, example: /dev/pts/3; tcp://<host>:<port>[?budget=<ms>] - serial-over-IP; repeat for several devices.", "port");
+	parser.addOption(portOption);
+	QCommandLineOption serialBackendOption("serial-backend", "Serial port <backend>: qt (default) or native (Linux termios).", "backend");
+	parser.addOption(serialBackendOption);
+	QCommandLineOption devicesOption("devices", "Drive <count> PSUs; default: 1 or --port & --sn count.", "count");
+	parser.addOption(devicesOption);
+	QCommandLineOption ioThreadsOption("io-threads", "Serve devices by <count> I/O threads at most; default: 4.", "count");
+	parser.addOption(ioThreadsOption);
+	QCommandLineOption syncOption("sync", "Poll all devices in lockstep rounds every <ms> & align samples to the rounds.", "ms");
+	parser.addOption(syncOption);
+	QCommandLineOption syncExportOption("sync-export", "Write aligned samples of lockstep rounds to CSV <file>.", "file");
+	parser.addOption(syncExportOption);
+	QCommandLineOption statusIntervalOption("status-interval", "Poll STATUS? after every <requests> of the polling cycle; 0 - don't poll; default: 4.", "requests");
+	parser.addOption(statusIntervalOption);
+	QCommandLineOption trackOption("track", "Set multichannel <mode> of 2 channel PSUs on connect: 0 - independent, 1 - series, 2 - parallel.", "mode");
+	parser.addOption(trackOption);
+	parser.process(a);
 
-	return a.exec();
+	if(parser.isSet(logLevelOption) && !Log::setLevels(parser.value(logLevelOption)))
+	{
+		std::cerr << "Wrong log levels " << qPrintable(parser.value(logLevelOption)) << std::endl;
+		return 1;
+	}
+
+	if(parser.isSet(decodeLogOption))
+	{
+		if(!Log::decode(parser.value(decodeLogOption), std::cout))
+		{
+			std::cerr << "Can't decode " << qPrintable(parser.value(decodeLogOption)) << std::endl;
+			return 1;
+		}
+		return 0;
+	}
+	if(parser.isSet(logBinaryOption) && !Log::setBinaryFile(parser.value(logBinaryOption)))
+		std::cerr << "Can't open " << qPrintable(parser.value(logBinaryOption)) << std::endl;
+
+	if(parser.isSet(traceOption) && !Trace::setFile(parser.value(traceOption)))
+		std::cerr << "Can't open " << qPrintable(parser.value(traceOption)) << std::endl;
+
+	MainWindowOptions options;
+	options.captureFileName = parser.value(captureOption);
+	options.replayFileName = parser.value(replayOption);
+	options.replayRealTime = !parser.isSet(replayFastOption);
+	options.statisticsFileName = parser.value(statsFileOption);
+	if(parser.isSet(statsIntervalOption))
+	{
+		bool ok;
+		options.statisticsInterval = parser.value(statsIntervalOption).toInt(&ok);
+		if(!ok || options.statisticsInterval < 0)
+		{
+			std::cerr << "Wrong statistics interval " << qPrintable(parser.value(statsIntervalOption)) << std::endl;
+			return 1;
+		}
+	}
+	options.metricsAddress = parser.value(metricsOption);
+	options.serialNumbers = parser.values(serialNumberOption);
+	options.portNames = parser.values(portOption);
+	if(parser.isSet(devicesOption))
+	{
+		bool ok;
+		options.devicesCount = parser.value(devicesOption).toInt(&ok);
+		if(!ok || options.devicesCount < 1)
+		{
+			std::cerr << "Wrong devices count " << qPrintable(parser.value(devicesOption)) << std::endl;
+			return 1;
+		}
+	}
+	if(parser.isSet(ioThreadsOption))
+	{
+		bool ok;
+		options.ioThreads = parser.value(ioThreadsOption).toInt(&ok);
+		if(!ok || options.ioThreads < 1)
+		{
+			std::cerr << "Wrong I/O threads count " << qPrintable(parser.value(ioThreadsOption)) << std::endl;
+			return 1;
+		}
+	}
+	if(parser.isSet(syncOption))
+	{
+		bool ok;
+		options.syncInterval = parser.value(syncOption).toInt(&ok);
+		if(!ok || options.syncInterval < 0)
+		{
+			std::cerr << "Wrong sync interval " << qPrintable(parser.value(syncOption)) << std::endl;
+			return 1;
+		}
+	}
+	options.syncExportFileName = parser.value(syncExportOption);
+	if(parser.isSet(statusIntervalOption))
+	{
+		bool ok;
+		options.statusInterval = parser.value(statusIntervalOption).toInt(&ok);
+		if(!ok || options.statusInterval < 0)
+		{
+			std::cerr << "Wrong status interval " << qPrintable(parser.value(statusIntervalOption)) << std::endl;
+			return 1;
+		}
+	}
+	if(parser.isSet(trackOption))
+	{
+		bool ok;
+		options.tracking = parser.value(trackOption).toInt(&ok);
+		if(!ok || options.tracking < 0 || options.tracking > 2)
+		{
+			std::cerr << "Wrong tracking mode " << qPrintable(parser.value(trackOption)) << std::endl;
+			return 1;
+		}
+	}
+	if(parser.isSet(serialBackendOption))
+	{
+		auto backend = parser.value(serialBackendOption);
+		if(backend != "qt" && backend != "native")
+		{
+			std::cerr << "Wrong serial backend " << qPrintable(backend) << std::endl;
+			return 1;
+		}
+		options.nativeSerial = backend == "native";
+	}
+	if(parser.isSet(lagThresholdOption))
+	{
+		bool ok;
+		options.lagThreshold = parser.value(lagThresholdOption).toInt(&ok);
+		if(!ok || options.lagThreshold < 1)
+		{
+			std::cerr << "Wrong lag threshold " << qPrintable(parser.value(lagThresholdOption)) << std::endl;
+			return 1;
+		}
+	}
+
+	int ret;
+	{
+		MainWindow w(options);
+		w.show();
+		ret = a.exec();
+	}
+	// after the window: destructor & I/O threads shutdown spans are written
+	Trace::close();
+	return ret;
 }
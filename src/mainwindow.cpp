@@ -1,50 +1,130 @@
+#include <functional>
 #include <QMetaEnum>
 #include <QFontDatabase>
+#include <QDockWidget>
+#include <QAction>
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 #include "Log.h"
+#include "Trace.h"
 
 #include <QThread>
+#ifdef Q_OS_UNIX
+#include <signal.h>
+#endif
 
-MainWindow::MainWindow(QWidget *parent) :
-	QMainWindow(parent), _protocol(), _graphParameters(6), _u_autoscale(30.), _i_autoscale(3.),
+MainWindow::MainWindow(const MainWindowOptions &options, QWidget *parent) :
+	QMainWindow(parent), _graphParameters(6), _u_autoscale(30.), _i_autoscale(3.),
 	ui(new Ui::MainWindow)
 {
+	// readouts font of the form
+	QFontDatabase::addApplicationFont(":/font/Digital-7.ttf");
 	ui->setupUi(this);
 
-	Log::msg(QString("MAIN %0").arg((ulong)QThread::currentThreadId(), 0, 16));
-	_protocol.moveToThread(&_protocolThread);
-	_protocolThread.start();
+	LOG_INFO(Gui, QString("MAIN %0").arg((ulong)QThread::currentThreadId(), 0, 16));
+	auto devicesCount = qMax(options.devicesCount, qMax(options.portNames.size(), options.serialNumbers.size()));
+	for(int i = 0; i < devicesCount; i++)
+	{
+		auto device = _devices.addDevice();
+		if(!options.portNames.value(i).isEmpty())
+			device->setPortName(options.portNames[i]);
+		device->setNativeBackend(options.nativeSerial);
+		device->setStatisticsFile(options.statisticsFileName, options.statisticsInterval);
+		device->setSerialNumber(options.serialNumbers.value(i));
+		device->setTracking(options.tracking);
+		device->setStatusInterval(options.statusInterval);
+	}
+	_readouts.resize(devicesCount);
+	// capture & replay are of the shown device
+	_device = _devices.device(0);
+	if(!options.captureFileName.isEmpty() && !_device->setCapture(options.captureFileName))
+		Log::error(QString("can't open capture ") + options.captureFileName);
+	if(!options.replayFileName.isEmpty() && !_device->setReplay(options.replayFileName, options.replayRealTime))
+		Log::error(QString("can't read replay ") + options.replayFileName);
+	// samples are taken from the devices rings by timer
+	connect(_device, SIGNAL(serialPortOpened(QString)), SLOT(_protocol_serialPortOpened(QString)));
+	connect(_device, SIGNAL(serialPortClosed(QString)), SLOT(_protocol_serialPortClosed(QString)));
+	connect(_device, SIGNAL(modelDetected(QString)), SLOT(_protocol_modelDetected(QString)));
+	connect(_device, SIGNAL(answerTimeout()), SLOT(_protocol_answerTimeout()));
+	connect(_device, SIGNAL(statusEvent(StatusClass::Event)), SLOT(_device_statusEvent(StatusClass::Event)));
+	// the output isn't switched until the PSU is detected
+	_outputAction = ui->toolBar->addAction("Output");
+	_outputAction->setCheckable(true);
+	_outputAction->setEnabled(false);
+	connect(_outputAction, SIGNAL(toggled(bool)), SLOT(_output_toggled(bool)));
+	_refreshTimerId = startTimer(REFRESH_INTERVAL);
+
+	if(devicesCount > 1)
+	{
+		// compact panels of all devices in one widget
+		_dashboard = new DashboardWidget;
+		_dashboard->setDevicesCount(devicesCount);
+		auto dock = new QDockWidget("Devices", this);
+		dock->setWidget(_dashboard);
+		addDockWidget(Qt::BottomDockWidgetArea, dock);
+		for(int i = 0; i < devicesCount; i++)
+			connect(_devices.device(i), &SerialPortClass::serialPortOpened, _dashboard, [this, i](QString portName) {
+				_dashboard->setDeviceName(i, QString("psu%0 %1").arg(i).arg(portName));
+			});
+	}
+	if(options.syncInterval > 0)
+	{
+		_sync = new SyncCaptureClass(&_devices, this);
+		if(!options.syncExportFileName.isEmpty() && !_sync->setExport(options.syncExportFileName))
+			Log::error(QString("can't open sync export ") + options.syncExportFileName);
+	}
 
-	QFontDatabase fontDB;
-	fontDB.addApplicationFont(":/font/Digital-7.ttf");
+	Trace::setThreadName("gui");
+	_startTimestamp = Log::timestamp();
+	_devices.start(options.ioThreads);
+	if(_sync)
+		_sync->start(options.syncInterval);
 
-	connect(&_protocol, SIGNAL(serialPortOpened(QString)), SLOT(_protocol_serialPortOpened(QString)));
-	connect(&_protocol, SIGNAL(serialPortClosed(QString)), SLOT(_protocol_serialPortClosed(QString)));
-	connect(&_protocol, SIGNAL(modelDetected(QString)), SLOT(_protocol_modelDetected(QString)));
-	connect(&_protocol, SIGNAL(answerTimeout()), SLOT(_protocol_answerTimeout()));
-	connect(&_protocol, SIGNAL(answer(ProtocolClass::RequestEnum,QByteArray)),
-		SLOT(_protocol_answer(ProtocolClass::RequestEnum,QByteArray)));
+	_watchdog.watch("gui", thread());
+	for(int i = 0; i < _devices.threadsCount(); i++)
+		_watchdog.watch(DeviceManagerClass::threadName(i), _devices.thread(i));
+	_watchdog.start(WatchdogClass::DEFAULT_INTERVAL, options.lagThreshold);
 
-	connect(this, SIGNAL(request(ProtocolClass::RequestEnum)), &_protocol, SLOT(request(ProtocolClass::RequestEnum)));
-	connect(this, SIGNAL(stop()), &_protocol, SLOT(stop()));
+	connect(this, SIGNAL(dumpStatistics()), &_devices, SLOT(dumpStatistics()));
+#ifdef Q_OS_UNIX
+	connect(&_unixSignal, SIGNAL(signalled(int)), SIGNAL(dumpStatistics()));
+	connect(&_unixSignal, SIGNAL(signalled(int)), SLOT(_dumpWatchdog()));
+	_unixSignal.handle(SIGUSR1);
+#endif
 
-	_time = QTime::currentTime();
+	if(!options.metricsAddress.isEmpty() && _metricsServer.listen(options.metricsAddress))
+	{
+		_updateMetrics();
+		_metricsTimerId = startTimer(METRICS_UPDATE_INTERVAL);
+	}
 
 	// setup the graph
 	{
 		auto plot = ui->oGraph;
 //		plot->setBackground(QBrush(Qt::darkGray));
-		// add graphs
+		// draw independent layers to own buffers concurrently
 		{
-			auto graph = plot->addGraph(plot->xAxis, plot->yAxis);
-			graph->setPen(_graphParameters.u());
-			graph->setName("V");
+			plot->setPlottingHint(QCP::phParallelLayers);
+			plot->addLayer("u", plot->layer("main"), QCustomPlot::limAbove);
+			plot->addLayer("i", plot->layer("u"), QCustomPlot::limAbove);
+			foreach(auto name, QStringList({ "grid", "u", "i", "axes" }))
+				plot->layer(name)->setMode(QCPLayer::lmBuffered);
 		}
+		// add graphs: all channels share the keys of the series
+		_series.reset(new SeriesClass(CHANNELS * 2));
+		static_assert(SyncCaptureClass::DEVICE_CHANNELS == CHANNELS * 2, "sync capture columns of a device");
+		if(_sync)
+			// aligned rows of all devices: the shown device is the first, its channels are the first columns
+			_sync->setSeries(_series, _startTimestamp);
+		for(int column = 0; column < CHANNELS * 2; column++)
 		{
-			auto graph = plot->addGraph(plot->xAxis, plot->yAxis2);
-			graph->setPen(_graphParameters.i());
-			graph->setName("A");
+			bool current = column % 2;
+			auto graph = new SeriesGraphClass(plot->xAxis, current ? plot->yAxis2 : plot->yAxis, _series, column);
+			graph->setPen(GraphParametersClass::channel(current ? _graphParameters.i() : _graphParameters.u(), column / 2));
+			graph->setName(QString(current ? "A%0" : "V%0").arg(column / 2 + 1));
+			graph->setLayer(current ? "i" : "u");
+			graph->setVisible(column < 2);
+			_graphs[column] = graph;
 		}
 		// add time axies
 		{
@@ -64,6 +144,29 @@ MainWindow::MainWindow(QWidget *parent) :
 		plot->yAxis2->setLabel("A");
 		plot->yAxis2->setVisible(true);
 		plot->yAxis2->setTickLabelColor(_graphParameters.i().color());
+		// add cursor: tracers snap to the nearest sample by binary search of the key
+		{
+			_u_tracer = new QCPItemTracer(plot);
+			_u_tracer->position->setAxes(plot->xAxis, plot->yAxis);
+			_u_tracer->setStyle(QCPItemTracer::tsCrosshair);
+			_u_tracer->setPen(QPen(Qt::gray));
+			_i_tracer = new QCPItemTracer(plot);
+			_i_tracer->position->setAxes(plot->xAxis, plot->yAxis2);
+			_i_tracer->setStyle(QCPItemTracer::tsCircle);
+			_i_tracer->setPen(_graphParameters.i());
+			_cursorText = new QCPItemText(plot);
+			_cursorText->setPositionAlignment(Qt::AlignTop | Qt::AlignLeft);
+			_cursorText->setTextAlignment(Qt::AlignLeft);
+			_cursorText->position->setType(QCPItemPosition::ptAxisRectRatio);
+			_cursorText->position->setCoords(0.01, 0.01);
+			foreach(QCPAbstractItem *item, QList<QCPAbstractItem *>({ _u_tracer, _i_tracer, _cursorText }))
+			{
+				// cursor is redrawn alone on it's buffered layer
+				item->setLayer("overlay");
+				item->setVisible(false);
+			}
+			connect(plot, SIGNAL(mouseMove(QMouseEvent*)), SLOT(_graph_mouseMove(QMouseEvent*)));
+		}
 	}
 }
 
@@ -71,21 +174,21 @@ MainWindow::~MainWindow()
 {
 	delete ui;
 
-	Log::msg("Wait for serial thread...");
-	emit stop();
-	_protocolThread.quit();
-	_protocolThread.wait(500);
-	Log::msg("Done");
+	LOG_INFO(Gui, "Wait for I/O threads...");
+	_devices.stop();
+	LOG_INFO(Gui, "Done");
 }
 
 void MainWindow::_protocol_serialPortOpened(QString portName)
 {
+	TRACE_SCOPE("gui", "_protocol_serialPortOpened");
 	_portName = portName;
 	ui->oStatusBar->showMessage(QString("Port: ") + portName);
 }
 
 void MainWindow::_protocol_serialPortClosed(QString portName)
 {
+	TRACE_SCOPE("gui", "_protocol_serialPortClosed");
 	_portName = portName;
 	ui->oStatusBar->showMessage(QString("Port: ") + portName + " closed");
 	ui->oVset1->setText("--.--");
@@ -96,51 +199,319 @@ void MainWindow::_protocol_serialPortClosed(QString portName)
 
 void MainWindow::_protocol_modelDetected(QString model)
 {
+	TRACE_SCOPE("gui", "_protocol_modelDetected");
 	ui->oStatusBar->showMessage(QString("Port: ") + _portName + "; Model: " + model);
 
-	// start the polling cycle
-	emit request(ProtocolClass::RequestEnum::VSET1Q);
+	// graph ranges of the model
+	if(auto traits = _device->model())
+	{
+		auto plot = ui->oGraph;
+		_u_autoscale = AutoscaleClass(traits->maxVoltage);
+		_i_autoscale = AutoscaleClass(traits->maxCurrent);
+		plot->yAxis->setRange(0, _u_autoscale.max * 1.05);
+		plot->yAxis2->setRange(0, _i_autoscale.max * 1.05);
+		for(int column = 2; column < CHANNELS * 2; column++)
+			_graphs[column]->setVisible(column / 2 < traits->channels);
+	}
 }
 
-void MainWindow::_protocol_answer(ProtocolClass::RequestEnum r, QByteArray value)
+int MainWindow::_column(ProtocolClass::RequestEnum r)
 {
-//	Log::msg(QString("%0 %1").arg((int)request).arg(QString(value)));
-	double key = _time.elapsed() / 1000.0; // seconds
-	auto plot = ui->oGraph;
-	auto v = QString(value).toFloat();
 	switch(r)
 	{
-		case ProtocolClass::RequestEnum::VSET1Q:
-			ui->oVset1->setText(value);
-			emit request(ProtocolClass::RequestEnum::ISET1Q);
-			break;
-		case ProtocolClass::RequestEnum::ISET1Q:
-			ui->oIset1->setText(value);
-			emit request(ProtocolClass::RequestEnum::VOUT1Q);
-			break;
-		case ProtocolClass::RequestEnum::VOUT1Q:
-			Log::msg(value);
-			ui->oVout->setText(value);
-			plot->graph(0)->addData(key, v);
-			if(_u_autoscale.scaleMax(v))
-				plot->yAxis->setRange(0, _u_autoscale.maxValue * 1.05);
-			plot->xAxis->setRange(key, _graphParameters.timeDept(), Qt::AlignRight);
-			plot->replot();
-			emit request(ProtocolClass::RequestEnum::IOUT1Q);
-			break;
-		case ProtocolClass::RequestEnum::IOUT1Q:
-			ui->oIout->setText(value);
-			plot->graph(1)->addData(key, QString(value).toFloat());
-			if(_i_autoscale.scaleMax(v))
-				plot->yAxis2->setRange(0, _i_autoscale.maxValue * 1.05);
+		case ProtocolClass::RequestEnum::VOUT1Q: return 0;
+		case ProtocolClass::RequestEnum::IOUT1Q: return 1;
+		case ProtocolClass::RequestEnum::VOUT2Q: return 2;
+		case ProtocolClass::RequestEnum::IOUT2Q: return 3;
+		default: return -1;
+	}
+}
+
+//! @return Readout text as PSU displays it, example: "05.00"
+static QString _readoutText(float value, int decimals)
+{
+	if(qIsNaN(value))
+		return decimals == 2 ? "--.--" : "-.---";
+	return QString("%1").arg(value, 5, 'f', decimals, QLatin1Char('0'));
+}
+
+void MainWindow::_drainSamples()
+{
+	TRACE_SCOPE("gui", "_drainSamples");
+	auto plot = ui->oGraph;
+	bool replot = false;
+	for(int i = 0; i < _devices.devicesCount(); i++)
+	{
+		auto device = _devices.device(i);
+		auto &readouts = _readouts[i];
+		if(!device->isUp())
+			readouts.uSet = readouts.iSet = readouts.uOut = readouts.iOut = NAN;
+		bool shown = device == _device;
+		if(shown)
+		{
+			_outputAction->setEnabled(device->isUp());
+			// the user switch stays until the next status poll
+			auto status = device->status();
+			if(status != _outputStatus)
+			{
+				_outputStatus = status;
+				QSignalBlocker blocker(_outputAction);
+				_outputAction->setChecked(status >= 0 && StatusClass((quint8)status).output());
+			}
+		}
+		if(_dashboard)
+			_dashboard->setDeviceUp(i, device->isUp());
+		DeviceClass::Sample sample;
+		while(device->pop(&sample))
+		{
+			if(_sync)
+				_sync->addSample(i, sample);
+			if(_dashboard && (sample.request == ProtocolClass::RequestEnum::VOUT1Q
+				|| sample.request == ProtocolClass::RequestEnum::IOUT1Q))
+				_dashboard->addSample(i, sample.request == ProtocolClass::RequestEnum::IOUT1Q ? 1 : 0,
+					(sample.timestamp - _startTimestamp) / 1e9, sample.value);
+			auto v = sample.value;
+			double key = (sample.timestamp - _startTimestamp) / 1e9; // seconds
+			switch(sample.request)
+			{
+				case ProtocolClass::RequestEnum::VSET1Q:
+					readouts.uSet = v;
+					if(shown)
+						ui->oVset1->setText(_readoutText(v, 2));
+					break;
+				case ProtocolClass::RequestEnum::ISET1Q:
+					readouts.iSet = v;
+					if(shown)
+						ui->oIset1->setText(_readoutText(v, 3));
+					break;
+				case ProtocolClass::RequestEnum::VOUT1Q:
+					readouts.uOut = v;
+					readouts.samples++;
+					if(!shown)
+						break;
+					LOG_INFO_ARGS(Gui, "VOUT1 %0", v);
+					ui->oVout->setText(_readoutText(v, 2));
+					break;
+				case ProtocolClass::RequestEnum::IOUT1Q:
+					readouts.iOut = v;
+					if(shown)
+						ui->oIout->setText(_readoutText(v, 3));
+					break;
+				default: break;
+			}
+			auto column = _column(sample.request);
+			if(!shown || column < 0)
+				continue;
+			// lockstep rounds rows are appended by the sync capture
+			if(!_sync)
+			{
+				if(sample.cycle != _rowCycle)
+				{
+					// a row per polling cycle keyed by the cycle start: the outputs of the cycle fill it
+					_rowCycle = sample.cycle;
+					_series->append((sample.cycle - _startTimestamp) / 1e9);
+				}
+				else if(!qIsNaN(_series->last(column)))
+					// answered twice in the cycle, example: resent by resync: the row keeps the first value
+					continue;
+				_series->setLast(column, v);
+			}
+			auto &autoscale = column % 2 ? _i_autoscale : _u_autoscale;
+			if(autoscale.scaleMax(v))
+				(column % 2 ? plot->yAxis2 : plot->yAxis)->setRange(0, autoscale.maxValue * 1.05);
 			plot->xAxis->setRange(key, _graphParameters.timeDept(), Qt::AlignRight);
-			plot->replot();
-			emit request(ProtocolClass::RequestEnum::VSET1Q);
-			break;
-		default: break;
+			replot = true;
+		}
 	}
+	if(_sync && _sync->alignRows())
+		replot = true;
+	// one replot for all samples taken
+	if(replot)
+		plot->replot();
 }
 
 void MainWindow::_protocol_answerTimeout()
 {
 }
+
+void MainWindow::_device_statusEvent(StatusClass::Event event)
+{
+	TRACE_SCOPE("gui", "_device_statusEvent");
+	ui->oStatusBar->showMessage(QString("Port: %0; %1 CH%2 at %3 s").arg(_portName).arg(StatusClass::eventName(event.type))
+		.arg(event.channel + 1).arg((qint64)(event.timestamp - _startTimestamp) / 1e9, 0, 'f', 3));
+}
+
+void MainWindow::_output_toggled(bool on)
+{
+	TRACE_SCOPE("gui", "_output_toggled");
+	// OUT0 & OUT1 are sent in the I/O thread between the cycle requests
+	QMetaObject::invokeMethod(_device, "setOutput", Qt::QueuedConnection, Q_ARG(bool, on));
+}
+
+void MainWindow::_dumpWatchdog()
+{
+	Log::msg(QString("watchdog:\n") + _watchdog.toText().trimmed());
+}
+
+void MainWindow::timerEvent(QTimerEvent *event)
+{
+	if(_refreshTimerId == event->timerId())
+		_drainSamples();
+	else if(_metricsTimerId == event->timerId())
+		_updateMetrics();
+	else
+		QMainWindow::timerEvent(event);
+}
+
+void MainWindow::_updateMetrics()
+{
+	TRACE_SCOPE("gui", "_updateMetrics");
+	double elapsed = _metricsTime.isValid() ? _metricsTime.restart() / 1000. : 0.;
+	if(!_metricsTime.isValid())
+		_metricsTime.start();
+	QVector<StatisticsClass> statistics;
+	QVector<QByteArray> labels;
+	for(int i = 0; i < _devices.devicesCount(); i++)
+	{
+		statistics.append(_devices.device(i)->statistics());
+		labels.append(QString("device=\"%0\"").arg(i).toUtf8());
+	}
+
+	QByteArray out;
+	struct
+	{
+		const char *name;
+		const char *help;
+		std::function<double(int)> value; //!< By device index
+	} gauges[] =
+	{
+		{ "korad_psu_up", "PSU model detected.", [&](int i) { return _devices.device(i)->isUp() ? 1. : 0.; } },
+		{ "korad_psu_voltage_volts", "Actual output voltage.", [&](int i) { return _readouts[i].uOut; } },
+		{ "korad_psu_current_amperes", "Actual output current.", [&](int i) { return _readouts[i].iOut; } },
+		{ "korad_psu_voltage_setpoint_volts", "Voltage as set by the user.", [&](int i) { return _readouts[i].uSet; } },
+		{ "korad_psu_current_setpoint_amperes", "Current as set by the user.", [&](int i) { return _readouts[i].iSet; } },
+		{ "korad_psu_sample_rate_hertz", "Voltage samples per second.", [&](int i) {
+			return elapsed > 0. ? (_readouts[i].samples - _readouts[i].metricsSamples) / elapsed : 0.; } },
+		{ "korad_psu_pending_requests", "Requests waiting for answer.", [&](int i) {
+			return (double)statistics[i].pendingRequests; } },
+		{ "korad_psu_link_delay_seconds", "One-way link delay estimate compensated in sample timestamps.", [&](int i) {
+			return _devices.device(i)->linkDelay() / 1e9; } },
+		{ "korad_psu_status", "The last STATUS? byte: -1 - not polled.", [&](int i) {
+			return (double)_devices.device(i)->status(); } },
+	};
+	for(auto &g : gauges)
+	{
+		MetricsServerClass::appendHeader(out, g.name, "gauge", g.help);
+		for(int i = 0; i < statistics.size(); i++)
+			MetricsServerClass::appendValue(out, g.name, g.value(i), labels[i]);
+	}
+	for(auto &readouts : _readouts)
+		readouts.metricsSamples = readouts.samples;
+
+	struct
+	{
+		const char *name;
+		const char *help;
+		quint64 StatisticsClass::*value;
+	} counters[] =
+	{
+		{ "korad_psu_requests_total", "Sent requests.", &StatisticsClass::requests },
+		{ "korad_psu_answers_total", "Completed answers.", &StatisticsClass::answers },
+		{ "korad_psu_timeouts_total", "Answer timeouts.", &StatisticsClass::timeouts },
+		{ "korad_psu_reconnects_total", "Serial port reconnects.", &StatisticsClass::reconnects },
+		{ "korad_psu_receive_bytes_total", "Read bytes.", &StatisticsClass::bytesIn },
+		{ "korad_psu_transmit_bytes_total", "Written bytes.", &StatisticsClass::bytesOut },
+		{ "korad_psu_dropped_requests_total", "Requests ignored since PSU model not detected.", &StatisticsClass::droppedRequests },
+		{ "korad_psu_duplicate_requests_total", "Requests ignored since the same request is pending.", &StatisticsClass::duplicateRequests },
+		{ "korad_psu_parse_failures_total", "Answers that can't be parsed.", &StatisticsClass::parseFailures },
+		{ "korad_psu_resync_resends_total", "Timeouts resolved by drain & resend.", &StatisticsClass::resyncResends },
+		{ "korad_psu_resync_pings_total", "Timeouts resolved by IDN ping & resend.", &StatisticsClass::resyncPings },
+		{ "korad_psu_resync_reconnects_total", "Timeouts resolved by full reconnect.", &StatisticsClass::resyncReconnects },
+		{ "korad_psu_unsupported_requests_total", "Requests ignored since PSU model doesn't support them.", &StatisticsClass::unsupportedRequests },
+		{ "korad_psu_status_events_total", "Status edges detected by STATUS? polls: CC/CV, output, OVP/OCP trip.", &StatisticsClass::statusEvents },
+	};
+	for(auto &c : counters)
+	{
+		MetricsServerClass::appendHeader(out, c.name, "counter", c.help);
+		for(int i = 0; i < statistics.size(); i++)
+			MetricsServerClass::appendValue(out, c.name, statistics[i].*c.value, labels[i]);
+	}
+	const char *overflows = "korad_psu_sample_ring_overflows_total";
+	MetricsServerClass::appendHeader(out, overflows, "counter", "Samples dropped since GUI didn't take them in time.");
+	for(int i = 0; i < statistics.size(); i++)
+		MetricsServerClass::appendValue(out, overflows, _devices.device(i)->overflows(), labels[i]);
+	const char *skippedRounds = "korad_psu_skipped_rounds_total";
+	MetricsServerClass::appendHeader(out, skippedRounds, "counter", "Lockstep rounds skipped since the previous round wasn't complete.");
+	for(int i = 0; i < statistics.size(); i++)
+		MetricsServerClass::appendValue(out, skippedRounds, _devices.device(i)->skippedRounds(), labels[i]);
+
+	const char *latency = "korad_psu_request_latency_seconds";
+	MetricsServerClass::appendHeader(out, latency, "summary", "Request to last answer byte latency.");
+	for(int i = 0; i < statistics.size(); i++)
+		for(auto it = statistics[i].latency.constBegin(); it != statistics[i].latency.constEnd(); ++it)
+		{
+			auto &h = it.value();
+			auto requestLabels = labels[i] + QString(",request=\"%0\"").arg(ProtocolClass::requestName(it.key())).toUtf8();
+			foreach(double q, QList<double>({ 0.5, 0.9, 0.99 }))
+				MetricsServerClass::appendValue(out, latency, h.quantile(q) / 1e6,
+					requestLabels + ",quantile=\"" + QByteArray::number(q) + '"');
+			MetricsServerClass::appendValue(out, (QByteArray(latency) + "_sum").constData(), h.sum() / 1e6, requestLabels);
+			MetricsServerClass::appendValue(out, (QByteArray(latency) + "_count").constData(), h.count(), requestLabels);
+		}
+	const char *eventLatency = "korad_psu_status_event_latency_seconds";
+	MetricsServerClass::appendHeader(out, eventLatency, "summary", "Previous STATUS? poll to status edge notification.");
+	for(int i = 0; i < statistics.size(); i++)
+	{
+		auto &h = statistics[i].statusEventLatency;
+		foreach(double q, QList<double>({ 0.5, 0.9, 0.99 }))
+			MetricsServerClass::appendValue(out, eventLatency, h.quantile(q) / 1e6,
+				labels[i] + ",quantile=\"" + QByteArray::number(q) + '"');
+		MetricsServerClass::appendValue(out, (QByteArray(eventLatency) + "_sum").constData(), h.sum() / 1e6, labels[i]);
+		MetricsServerClass::appendValue(out, (QByteArray(eventLatency) + "_count").constData(), h.count(), labels[i]);
+	}
+	const char *lag = "korad_psu_event_loop_lag_seconds";
+	MetricsServerClass::appendHeader(out, lag, "summary", "Event loop heartbeat dispatch lag.");
+	foreach(auto &h, _watchdog.histograms())
+	{
+		auto labels = QString("thread=\"%0\"").arg(h.first).toUtf8();
+		foreach(double q, QList<double>({ 0.5, 0.9, 0.99 }))
+			MetricsServerClass::appendValue(out, lag, h.second.quantile(q) / 1e6,
+				labels + ",quantile=\"" + QByteArray::number(q) + '"');
+		MetricsServerClass::appendValue(out, (QByteArray(lag) + "_sum").constData(), h.second.sum() / 1e6, labels);
+		MetricsServerClass::appendValue(out, (QByteArray(lag) + "_count").constData(), h.second.count(), labels);
+	}
+
+	_metricsServer.setMetrics(out);
+}
+
+void MainWindow::_graph_mouseMove(QMouseEvent *event)
+{
+	TRACE_SCOPE("gui", "_graph_mouseMove");
+	auto plot = ui->oGraph;
+	bool visible = plot->axisRect()->rect().contains(event->pos()) && !_series->isEmpty();
+	if(visible)
+	{
+		double key = plot->xAxis->pixelToCoord(event->pos().x());
+		// nearest row; tracers follow CH1
+		QString text;
+		for(int column = 0; column < CHANNELS * 2; column++)
+		{
+			if(!_graphs[column]->visible())
+				continue;
+			double valueKey = key;
+			float value = _graphs[column]->nearest(&valueKey);
+			if(!column)
+				text = QString("%0 s").arg(valueKey, 0, 'f', 3);
+			if(column < 2)
+				(column ? _i_tracer : _u_tracer)->position->setCoords(valueKey, value);
+			text += QString(column % 2 ? " %0 A" : "\n%0 V").arg(value, 0, 'f', column % 2 ? 3 : 2);
+		}
+		_cursorText->setText(text);
+	}
+	else if(!_cursorText->visible())
+		return;
+	_u_tracer->setVisible(visible);
+	_i_tracer->setVisible(visible);
+	_cursorText->setVisible(visible);
+	plot->layer("overlay")->replot();
+}
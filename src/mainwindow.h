@@ -7,12 +7,45 @@
 #include <QThread>
 #include <QPen>
 #include <QTime>
-#include "ProtocolClass.h"
+#include <QElapsedTimer>
+#include <QMouseEvent>
+#include "DeviceManagerClass.h"
+#include "SyncCaptureClass.h"
+#include "DashboardWidget.h"
+#include "UnixSignalClass.h"
+#include "MetricsServerClass.h"
+#include "WatchdogClass.h"
+#include "SeriesGraphClass.h"
 
 namespace Ui {
 	class MainWindow;
 }
 
+class QAction;
+class QCPItemTracer;
+class QCPItemText;
+
+//! Command line options
+struct MainWindowOptions
+{
+	QString captureFileName; //!< Serial port wire capture file
+	QString replayFileName; //!< Wire capture file to replay instead of serial port
+	bool replayRealTime = true; //!< Replay with original timing or as fast as possible
+	QString statisticsFileName; //!< File to append protocol statistics
+	int statisticsInterval = 0; //!< Statistics file write interval, s: 0 - on SIGUSR1 only
+	QString metricsAddress; //!< Prometheus metrics listen address: "unix:<path>" or "[<host>:]<port>"
+	int lagThreshold = WatchdogClass::DEFAULT_THRESHOLD; //!< Event loops lag warning threshold, ms
+	QStringList serialNumbers; //!< Wanted PSU serial numbers by device: empty - any
+	QStringList portNames; //!< Serial ports to open by device: empty - search by USB VID:PID
+	bool nativeSerial = false; //!< Native termios serial port backend instead of QSerialPort
+	int devicesCount = 1; //!< PSUs to drive: at least ports & serial numbers count
+	int ioThreads = DeviceManagerClass::DEFAULT_THREADS; //!< I/O threads count limit
+	int syncInterval = 0; //!< Lockstep polling rounds interval, ms: 0 - devices poll free running
+	QString syncExportFileName; //!< CSV file for aligned samples of lockstep rounds
+	int statusInterval = DeviceClass::DEFAULT_STATUS_INTERVAL; //!< Polling cycle requests between STATUS? polls: 0 - not polled
+	int tracking = -1; //!< Multichannel mode set on model detection: -1 - keep; 0 - independent; 1 - series; 2 - parallel
+};
+
 class MainWindow : public QMainWindow
 {
 	Q_OBJECT
@@ -25,6 +58,8 @@ protected:
 		uint ticksCount; //!< ticks count of u & i
 		QPen u() const { return QPen(QBrush(Qt::blue), 2); }
 		QPen i() const { return QPen(QBrush(Qt::red), 2); }
+		//! @return Pen of the channel: CH2 is dashed
+		static QPen channel(QPen pen, int channel) { if(channel) pen.setStyle(Qt::DashLine); return pen; }
 		uint timeDept() const { return 60; } // seconds
 		uint timeTick() const { return 10; } // seconds
 	};
@@ -51,28 +86,70 @@ protected:
 	};
 
 public:
-	explicit MainWindow(QWidget *parent = 0);
+	explicit MainWindow(const MainWindowOptions &options, QWidget *parent = 0);
 	~MainWindow();
 
 signals:
-	void request(ProtocolClass::RequestEnum r);
-	void stop();
+	void dumpStatistics();
 
 protected slots:
 	void _protocol_serialPortOpened(QString portName);
 	void _protocol_serialPortClosed(QString portName);
 	void _protocol_modelDetected(QString model);
-	void _protocol_answer(ProtocolClass::RequestEnum r, QByteArray value);
 	void _protocol_answerTimeout();
+	void _device_statusEvent(StatusClass::Event event);
+	//! Switches the output of the shown device between its polling cycle requests
+	void _output_toggled(bool on);
+	void _graph_mouseMove(QMouseEvent *event);
+	//! Writes event loops lag histograms to log
+	void _dumpWatchdog();
 
 protected:
-	ProtocolClass _protocol;
-	QThread _protocolThread;
+	static constexpr int METRICS_UPDATE_INTERVAL = 1000; //!< Metrics snapshot update interval, ms
+	static constexpr int REFRESH_INTERVAL = 20; //!< Samples rings drain interval, ms
+	static constexpr int CHANNELS = 2; //!< Channels shown by the graph
+
+	//! @return Series column of the output request: U1, I1, U2, I2; -1 - not an output
+	static int _column(ProtocolClass::RequestEnum r);
+
+	//! Device readouts; GUI thread only
+	struct Readouts
+	{
+		double uSet = NAN, iSet = NAN, uOut = NAN, iOut = NAN; //!< Last readouts
+		quint64 samples = 0; //!< VOUT1Q samples count
+		quint64 metricsSamples = 0; //!< Samples count at the last metrics snapshot update
+	};
+
+	DeviceManagerClass _devices;
+	DeviceClass *_device = nullptr; //!< Device shown by the window
+	QVector<Readouts> _readouts; //!< By device index
+	SyncCaptureClass *_sync = nullptr; //!< Lockstep rounds: nullptr - devices poll free running
+	DashboardWidget *_dashboard = nullptr; //!< Panels of all devices: nullptr - the only device
+	int _refreshTimerId = -1; //!< Samples rings drain timer ID
+	QAction *_outputAction = nullptr; //!< Output switch of the shown device: checked by its polled status
+	int _outputStatus = -1; //!< The shown device status the output switch is checked by: -1 - not polled
+	UnixSignalClass _unixSignal; //!< SIGUSR1 dumps protocol statistics
+	WatchdogClass _watchdog; //!< GUI & I/O threads event loops lag
 	QString _portName;
 	GraphParametersClass _graphParameters;
-	QTime _time;
+	quint64 _startTimestamp; //!< Graph time origin, Log::timestamp(), ns
 	AutoscaleClass _u_autoscale;
 	AutoscaleClass _i_autoscale;
+	QSharedPointer<SeriesClass> _series; //!< Graph rows: by polling cycle, or aligned rows of the sync capture; columns by _column()
+	quint64 _rowCycle = 0; //!< Polling cycle of the last row: DeviceClass::Sample::cycle
+	SeriesGraphClass *_graphs[CHANNELS * 2] = {}; //!< By series column; CH2 graphs are hidden until a 2 channel model
+	QCPItemTracer *_u_tracer; //!< Graph cursor: V sample nearest to mouse
+	QCPItemTracer *_i_tracer; //!< Graph cursor: A sample nearest to mouse
+	QCPItemText *_cursorText; //!< Graph cursor readout: time, V, A of the shown channels
+	MetricsServerClass _metricsServer;
+	int _metricsTimerId = -1; //!< Metrics snapshot update timer ID: -1 - metrics are not served
+	QElapsedTimer _metricsTime; //!< Since the last metrics snapshot update
+
+	void timerEvent(QTimerEvent *event) override;
+	//! Takes samples of all devices; updates readouts & the graph of the shown device
+	void _drainSamples();
+	//! Makes the metrics snapshot for scrapes
+	void _updateMetrics();
 
 private:
 	Ui::MainWindow *ui;
@@ -24,6 +24,23 @@
 ****************************************************************************/
 
 #include "qcustomplot.h"
+// replot spans for the application trace (see Trace.h), compiled in if QCUSTOMPLOT_USE_TRACE is defined:
+#ifdef QCUSTOMPLOT_USE_TRACE
+#  include <QtCore/QThread>
+#  include <QtCore/QCoreApplication>
+#  include "Trace.h"
+#  define QCP_TRACE_SCOPE(name) TRACE_SCOPE("render", name)
+// the calling (GUI) thread may run a part of the concurrent work too: only pool threads are named
+#  define QCP_TRACE_THREAD(name) do { if (QThread::currentThread() != QCoreApplication::instance()->thread()) Trace::setThreadName(name); } while (false)
+#else
+#  define QCP_TRACE_SCOPE(name)
+#  define QCP_TRACE_THREAD(name)
+#endif
+#if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
+#  include <QtCore/QtConcurrentMap>
+#else
+#  include <QtConcurrent/QtConcurrentMap>
+#endif
 
 
 /* including file 'src/vector2d.cpp', size 7340                              */
@@ -707,6 +724,78 @@ void QCPPaintBufferPixmap::reallocateBuffer()
 }
 
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPPaintBufferImage
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPPaintBufferImage
+  \brief A paint buffer based on QImage, using software raster rendering
+
+  This paint buffer uses software rendering and a premultiplied ARGB QImage as internal buffer.
+  Unlike QPixmap, a QImage may be painted on outside the GUI thread, so this buffer is used instead
+  of \ref QCPPaintBufferPixmap if the plotting hint \ref QCP::phParallelLayers is set and OpenGL is
+  disabled. Then the layers of different buffers are drawn concurrently (see \ref
+  QCustomPlot::replot).
+*/
+
+/*!
+  Creates an image paint buffer instance with the specified \a size and \a devicePixelRatio, if
+  applicable.
+*/
+QCPPaintBufferImage::QCPPaintBufferImage(const QSize &size, double devicePixelRatio) :
+  QCPAbstractPaintBuffer(size, devicePixelRatio)
+{
+  QCPPaintBufferImage::reallocateBuffer();
+}
+
+QCPPaintBufferImage::~QCPPaintBufferImage()
+{
+}
+
+/* inherits documentation from base class */
+QCPPainter *QCPPaintBufferImage::startPainting()
+{
+  QCPPainter *result = new QCPPainter(&mBuffer);
+  result->setRenderHint(QPainter::HighQualityAntialiasing);
+  return result;
+}
+
+/* inherits documentation from base class */
+void QCPPaintBufferImage::draw(QCPPainter *painter) const
+{
+  if (painter && painter->isActive())
+    painter->drawImage(0, 0, mBuffer);
+  else
+    qDebug() << Q_FUNC_INFO << "invalid or inactive painter passed";
+}
+
+/* inherits documentation from base class */
+void QCPPaintBufferImage::clear(const QColor &color)
+{
+  mBuffer.fill(color);
+}
+
+/* inherits documentation from base class */
+void QCPPaintBufferImage::reallocateBuffer()
+{
+  setInvalidated();
+  if (!qFuzzyCompare(1.0, mDevicePixelRatio))
+  {
+#ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
+    mBuffer = QImage(mSize*mDevicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    mBuffer.setDevicePixelRatio(mDevicePixelRatio);
+#else
+    qDebug() << Q_FUNC_INFO << "Device pixel ratios not supported for Qt versions before 5.4";
+    mDevicePixelRatio = 1.0;
+    mBuffer = QImage(mSize, QImage::Format_ARGB32_Premultiplied);
+#endif
+  } else
+  {
+    mBuffer = QImage(mSize, QImage::Format_ARGB32_Premultiplied);
+  }
+}
+
+
 #ifdef QCP_OPENGL_PBUFFER
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////// QCPPaintBufferGlPbuffer
@@ -5496,7 +5585,9 @@ void QCPLineEnding::draw(QCPPainter *painter, const QCPVector2D &pos, double ang
 QCPAxisTicker::QCPAxisTicker() :
   mTickStepStrategy(tssReadability),
   mTickCount(5),
-  mTickOrigin(0)
+  mTickOrigin(0),
+  mLabelCacheTickStep(0),
+  mLabelCachePrecision(-1)
 {
 }
 
@@ -5578,7 +5669,18 @@ void QCPAxisTicker::generate(const QCPRange &range, const QLocale &locale, QChar
   trimTicks(range, ticks, false);
   // generate labels for visible ticks if requested:
   if (tickLabels)
+  {
+    // cached labels may only be reused as long as the label formatting parameters are unchanged:
+    if (tickStep != mLabelCacheTickStep || locale != mLabelCacheLocale || formatChar != mLabelCacheFormatChar || precision != mLabelCachePrecision)
+    {
+      clearLabelCache();
+      mLabelCacheTickStep = tickStep;
+      mLabelCacheLocale = locale;
+      mLabelCacheFormatChar = formatChar;
+      mLabelCachePrecision = precision;
+    }
     *tickLabels = createLabelVector(ticks, locale, formatChar, precision);
+  }
 }
 
 /*! \internal
@@ -5730,7 +5832,10 @@ QVector<double> QCPAxisTicker::createTickVector(double tickStep, const QCPRange
   
   Returns a vector containing all tick label strings corresponding to the tick coordinates provided
   in \a ticks. The default implementation calls \ref getTickLabel to generate the respective
-  strings.
+  strings. Labels of ticks that were already present in the previous call are taken from the label
+  cache instead, so scrolling the axis range only formats the labels of ticks entering the range.
+  Subclasses whose labels depend on additional settings must call \ref clearLabelCache when those
+  settings change.
   
   It is possible but uncommon for QCPAxisTicker subclasses to reimplement this method, as
   reimplementing \ref getTickLabel often achieves the intended result easier.
@@ -5739,8 +5844,16 @@ QVector<QString> QCPAxisTicker::createLabelVector(const QVector<double> &ticks,
 {
   QVector<QString> result;
   result.reserve(ticks.size());
+  QMap<double, QString> labelCache;
   for (int i=0; i<ticks.size(); ++i)
-    result.append(getTickLabel(ticks.at(i), locale, formatChar, precision));
+  {
+    // reuse labels of ticks that were visible in the last call, e.g. when the range is scrolled:
+    QMap<double, QString>::const_iterator it = mLabelCache.constFind(ticks.at(i));
+    const QString label = it != mLabelCache.constEnd() ? it.value() : getTickLabel(ticks.at(i), locale, formatChar, precision);
+    result.append(label);
+    labelCache.insert(ticks.at(i), label);
+  }
+  mLabelCache = labelCache; // only keep labels of current ticks, so the cache doesn't grow while scrolling
   return result;
 }
 
@@ -5847,6 +5960,18 @@ double QCPAxisTicker::cleanMantissa(double input) const
   }
   return input;
 }
+
+/*! \internal
+  
+  Discards all cached tick labels, so they are generated again with \ref getTickLabel on the next
+  call of \ref generate.
+  
+  \see createLabelVector
+*/
+void QCPAxisTicker::clearLabelCache()
+{
+  mLabelCache.clear();
+}
 /* end of 'src/axis/axisticker.cpp' */
 
 
@@ -5914,6 +6039,7 @@ QCPAxisTickerDateTime::QCPAxisTickerDateTime() :
 */
 void QCPAxisTickerDateTime::setDateTimeFormat(const QString &format)
 {
+  clearLabelCache();
   mDateTimeFormat = format;
 }
 
@@ -5929,6 +6055,7 @@ void QCPAxisTickerDateTime::setDateTimeFormat(const QString &format)
 */
 void QCPAxisTickerDateTime::setDateTimeSpec(Qt::TimeSpec spec)
 {
+  clearLabelCache();
   mDateTimeSpec = spec;
 }
 
@@ -6232,6 +6359,7 @@ QCPAxisTickerTime::QCPAxisTickerTime() :
 */
 void QCPAxisTickerTime::setTimeFormat(const QString &format)
 {
+  clearLabelCache();
   mTimeFormat = format;
   
   // determine smallest and biggest unit in format, to optimize unit replacement and allow biggest
@@ -6263,6 +6391,7 @@ void QCPAxisTickerTime::setTimeFormat(const QString &format)
 */
 void QCPAxisTickerTime::setFieldWidth(QCPAxisTickerTime::TimeUnit unit, int width)
 {
+  clearLabelCache();
   mFieldWidth[unit] = qMax(width, 1);
 }
 
@@ -6558,6 +6687,7 @@ QCPAxisTickerText::QCPAxisTickerText() :
 */
 void QCPAxisTickerText::setTicks(const QMap<double, QString> &ticks)
 {
+  clearLabelCache();
   mTicks = ticks;
 }
 
@@ -6571,6 +6701,7 @@ void QCPAxisTickerText::setTicks(const QMap<double, QString> &ticks)
 */
 void QCPAxisTickerText::setTicks(const QVector<double> &positions, const QVector<QString> &labels)
 {
+  clearLabelCache();
   clear();
   addTicks(positions, labels);
 }
@@ -6598,6 +6729,7 @@ void QCPAxisTickerText::setSubTickCount(int subTicks)
 */
 void QCPAxisTickerText::clear()
 {
+  clearLabelCache();
   mTicks.clear();
 }
 
@@ -6609,6 +6741,7 @@ void QCPAxisTickerText::clear()
 */
 void QCPAxisTickerText::addTick(double position, const QString &label)
 {
+  clearLabelCache();
   mTicks.insert(position, label);
 }
 
@@ -6624,6 +6757,7 @@ void QCPAxisTickerText::addTick(double position, const QString &label)
 */
 void QCPAxisTickerText::addTicks(const QMap<double, QString> &ticks)
 {
+  clearLabelCache();
   mTicks.unite(ticks);
 }
 
@@ -6640,6 +6774,7 @@ void QCPAxisTickerText::addTicks(const QMap<double, QString> &ticks)
 */
 void QCPAxisTickerText::addTicks(const QVector<double> &positions, const QVector<QString> &labels)
 {
+  clearLabelCache();
   if (positions.size() != labels.size())
     qDebug() << Q_FUNC_INFO << "passed unequal length vectors for positions and labels:" << positions.size() << labels.size();
   int n = qMin(positions.size(), labels.size());
@@ -6756,6 +6891,7 @@ QCPAxisTickerPi::QCPAxisTickerPi() :
 */
 void QCPAxisTickerPi::setPiSymbol(QString symbol)
 {
+  clearLabelCache();
   mPiSymbol = symbol;
 }
 
@@ -6767,6 +6903,7 @@ void QCPAxisTickerPi::setPiSymbol(QString symbol)
 */
 void QCPAxisTickerPi::setPiValue(double pi)
 {
+  clearLabelCache();
   mPiValue = pi;
 }
 
@@ -6780,6 +6917,7 @@ void QCPAxisTickerPi::setPiValue(double pi)
 */
 void QCPAxisTickerPi::setPeriodicity(int multiplesOfPi)
 {
+  clearLabelCache();
   mPeriodicity = qAbs(multiplesOfPi);
 }
 
@@ -6789,6 +6927,7 @@ void QCPAxisTickerPi::setPeriodicity(int multiplesOfPi)
 */
 void QCPAxisTickerPi::setFractionStyle(QCPAxisTickerPi::FractionStyle style)
 {
+  clearLabelCache();
   mFractionStyle = style;
 }
 
@@ -9519,7 +9658,7 @@ void QCPAxisPainterPrivate::placeTickLabel(QCPPainter *painter, double position,
       cachedLabel->offset = getTickLabelDrawOffset(labelData)+labelData.rotatedTotalBounds.topLeft();
       if (!qFuzzyCompare(1.0, mParentPlot->bufferDevicePixelRatio()))
       {
-        cachedLabel->pixmap = QPixmap(labelData.rotatedTotalBounds.size()*mParentPlot->bufferDevicePixelRatio());
+        cachedLabel->pixmap = QImage(labelData.rotatedTotalBounds.size()*mParentPlot->bufferDevicePixelRatio(), QImage::Format_ARGB32_Premultiplied);
 #ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
 #  ifdef QCP_DEVICEPIXELRATIO_FLOAT
         cachedLabel->pixmap.setDevicePixelRatio(mParentPlot->devicePixelRatioF());
@@ -9528,7 +9667,7 @@ void QCPAxisPainterPrivate::placeTickLabel(QCPPainter *painter, double position,
 #  endif
 #endif
       } else
-        cachedLabel->pixmap = QPixmap(labelData.rotatedTotalBounds.size());
+        cachedLabel->pixmap = QImage(labelData.rotatedTotalBounds.size(), QImage::Format_ARGB32_Premultiplied);
       cachedLabel->pixmap.fill(Qt::transparent);
       QCPPainter cachePainter(&cachedLabel->pixmap);
       cachePainter.setPen(painter->pen());
@@ -9545,7 +9684,7 @@ void QCPAxisPainterPrivate::placeTickLabel(QCPPainter *painter, double position,
     }
     if (!labelClippedByBorder)
     {
-      painter->drawPixmap(labelAnchor+cachedLabel->offset, cachedLabel->pixmap);
+      painter->drawImage(labelAnchor+cachedLabel->offset, cachedLabel->pixmap);
       finalSize = cachedLabel->pixmap.size()/mParentPlot->bufferDevicePixelRatio();
     }
     mLabelCache.insert(text, cachedLabel); // return label to cache or insert for the first time if newly created
@@ -13184,7 +13323,14 @@ void QCustomPlot::setNoAntialiasingOnDrag(bool enabled)
 */
 void QCustomPlot::setPlottingHints(const QCP::PlottingHints &hints)
 {
+  bool parallelLayersChanged = mPlottingHints.testFlag(QCP::phParallelLayers) != hints.testFlag(QCP::phParallelLayers);
   mPlottingHints = hints;
+  // recreate all paint buffers, so they are of the type appropriate for (non-)parallel drawing:
+  if (parallelLayersChanged)
+  {
+    mPaintBuffers.clear();
+    setupPaintBuffers();
+  }
 }
 
 /*!
@@ -14434,15 +14580,21 @@ void QCustomPlot::replot(QCustomPlot::RefreshPriority refreshPriority)
   
   if (mReplotting) // incase signals loop back to replot slot
     return;
+  QCP_TRACE_SCOPE("replot");
   mReplotting = true;
   mReplotQueued = false;
   emit beforeReplot();
   
-  updateLayout();
+  {
+    QCP_TRACE_SCOPE("layout");
+    updateLayout();
+  }
   // draw all layered objects (grid, axes, plottables, items, legend,...) into their buffers:
   setupPaintBuffers();
-  foreach (QCPLayer *layer, mLayers)
-    layer->drawToPaintBuffer();
+  {
+    QCP_TRACE_SCOPE("draw");
+    drawLayersToPaintBuffers();
+  }
   for (int i=0; i<mPaintBuffers.size(); ++i)
     mPaintBuffers.at(i)->setInvalidated(false);
   
@@ -15144,10 +15296,56 @@ QCPAbstractPaintBuffer *QCustomPlot::createPaintBuffer()
     qDebug() << Q_FUNC_INFO << "OpenGL enabled even though no support for it compiled in, this shouldn't have happened. Falling back to pixmap paint buffer.";
     return new QCPPaintBufferPixmap(viewport().size(), mBufferDevicePixelRatio);
 #endif
-  } else
+  } else if (mPlottingHints.testFlag(QCP::phParallelLayers))
+    return new QCPPaintBufferImage(viewport().size(), mBufferDevicePixelRatio);
+  else
     return new QCPPaintBufferPixmap(viewport().size(), mBufferDevicePixelRatio);
 }
 
+/*! \internal
+
+  Draws all layers into their associated paint buffers. This method is called by \ref replot after
+  \ref setupPaintBuffers.
+
+  If the plotting hint \ref QCP::phParallelLayers is set (and OpenGL is disabled), the layers are
+  grouped by the paint buffer they share, and the groups are drawn concurrently on the global
+  thread pool. Layers sharing one buffer are still drawn sequentially in their stacking order, so
+  the result is identical to the sequential path. This method blocks until all buffers are drawn.
+*/
+void QCustomPlot::drawLayersToPaintBuffers()
+{
+  if (mOpenGl || !mPlottingHints.testFlag(QCP::phParallelLayers) || mPaintBuffers.size() < 2)
+  {
+    foreach (QCPLayer *layer, mLayers)
+      layer->drawToPaintBuffer();
+    return;
+  }
+  
+  // group consecutive layers by their paint buffer (setupPaintBuffers assigns buffers in layer order):
+  QList<QList<QCPLayer*> > bufferLayers;
+  QCPAbstractPaintBuffer *lastBuffer = 0;
+  foreach (QCPLayer *layer, mLayers)
+  {
+    QCPAbstractPaintBuffer *buffer = layer->mPaintBuffer.data();
+    if (bufferLayers.isEmpty() || buffer != lastBuffer)
+      bufferLayers.append(QList<QCPLayer*>());
+    bufferLayers.last().append(layer);
+    lastBuffer = buffer;
+  }
+  
+  struct DrawLayers
+  {
+    void operator()(const QList<QCPLayer*> &layers) const
+    {
+      QCP_TRACE_THREAD("render");
+      QCP_TRACE_SCOPE("draw buffer");
+      foreach (QCPLayer *layer, layers)
+        layer->drawToPaintBuffer();
+    }
+  };
+  QtConcurrent::blockingMap(bufferLayers, DrawLayers());
+}
+
 /*!
   This method returns whether any of the paint buffers held by this QCustomPlot instance are
   invalidated.
@@ -20366,7 +20564,10 @@ void QCPGraph::draw(QCPPainter *painter)
     bool isSelectedSegment = i >= unselectedSegments.size();
     // get line pixel points appropriate to line style:
     QCPDataRange lineDataRange = isSelectedSegment ? allSegments.at(i) : allSegments.at(i).adjusted(-1, 1); // unselected segments extend lines to bordering selected data point (safe to exceed total data bounds in first/last segment, getLines takes care)
-    getLines(&lines, lineDataRange);
+    {
+      QCP_TRACE_SCOPE("getLines");
+      getLines(&lines, lineDataRange);
+    }
     
     // check data validity if flag set:
 #ifdef QCUSTOMPLOT_CHECK_DATA
@@ -56,6 +56,7 @@
 #include <QtGui/QMouseEvent>
 #include <QtGui/QWheelEvent>
 #include <QtGui/QPixmap>
+#include <QtGui/QImage>
 #include <QtCore/QVector>
 #include <QtCore/QString>
 #include <QtCore/QDateTime>
@@ -243,6 +244,8 @@ enum PlottingHint { phNone              = 0x000 ///< <tt>0x000</tt> No hints are
                     ,phImmediateRefresh = 0x002 ///< <tt>0x002</tt> causes an immediate repaint() instead of a soft update() when QCustomPlot::replot() is called with parameter \ref QCustomPlot::rpRefreshHint.
                                                 ///<                This is set by default to prevent the plot from freezing on fast consecutive replots (e.g. user drags ranges with mouse).
                     ,phCacheLabels      = 0x004 ///< <tt>0x004</tt> axis (tick) labels will be cached as pixmaps, increasing replot performance.
+                    ,phParallelLayers   = 0x008 ///< <tt>0x008</tt> paint buffers of buffered layers (\ref QCPLayer::lmBuffered) are QImage based and drawn concurrently on the global thread pool during \ref QCustomPlot::replot.
+                                                ///<                Has no effect if OpenGL is enabled.
                   };
 Q_DECLARE_FLAGS(PlottingHints, PlottingHint)
 
@@ -572,6 +575,26 @@ protected:
 };
 
 
+class QCP_LIB_DECL QCPPaintBufferImage : public QCPAbstractPaintBuffer
+{
+public:
+  explicit QCPPaintBufferImage(const QSize &size, double devicePixelRatio);
+  virtual ~QCPPaintBufferImage();
+  
+  // reimplemented virtual methods:
+  virtual QCPPainter *startPainting() Q_DECL_OVERRIDE;
+  virtual void draw(QCPPainter *painter) const Q_DECL_OVERRIDE;
+  void clear(const QColor &color) Q_DECL_OVERRIDE;
+  
+protected:
+  // non-property members:
+  QImage mBuffer;
+  
+  // reimplemented virtual methods:
+  virtual void reallocateBuffer() Q_DECL_OVERRIDE;
+};
+
+
 #ifdef QCP_OPENGL_PBUFFER
 class QCP_LIB_DECL QCPPaintBufferGlPbuffer : public QCPAbstractPaintBuffer
 {
@@ -1573,6 +1596,13 @@ protected:
   int mTickCount;
   double mTickOrigin;
   
+  // non-property members:
+  QMap<double, QString> mLabelCache; // labels of the last generated ticks, valid for the parameters below
+  double mLabelCacheTickStep;
+  QLocale mLabelCacheLocale;
+  QChar mLabelCacheFormatChar;
+  int mLabelCachePrecision;
+  
   // introduced virtual methods:
   virtual double getTickStep(const QCPRange &range);
   virtual int getSubTickCount(double tickStep);
@@ -1586,6 +1616,7 @@ protected:
   double pickClosest(double target, const QVector<double> &candidates) const;
   double getMantissa(double input, double *magnitude=0) const;
   double cleanMantissa(double input) const;
+  void clearLabelCache();
   
 private:
   Q_DISABLE_COPY(QCPAxisTicker)
@@ -2265,7 +2296,7 @@ protected:
   struct CachedLabel
   {
     QPointF offset;
-    QPixmap pixmap;
+    QImage pixmap; // QImage instead of QPixmap, so labels may be cached outside the GUI thread (see QCP::phParallelLayers)
   };
   struct TickLabelData
   {
@@ -3834,6 +3865,7 @@ protected:
   void drawBackground(QCPPainter *painter);
   void setupPaintBuffers();
   QCPAbstractPaintBuffer *createPaintBuffer();
+  void drawLayersToPaintBuffers();
   bool hasInvalidatedPaintBuffers();
   bool setupOpenGl();
   void freeOpenGl();
@@ -0,0 +1,16 @@
+include(../tests.pri)
+
+QT += serialport network concurrent
+
+TARGET = tst_device
+
+SOURCES += \
+	tst_device.cpp \
+	$$PROTOCOL_SOURCES \
+	$$SRC/StatusClass.cpp \
+	$$SRC/DeviceClass.cpp
+
+HEADERS += \
+	$$PROTOCOL_HEADERS \
+	$$SRC/StatusClass.h \
+	$$SRC/DeviceClass.h
@@ -0,0 +1,106 @@
+#include <QtTest>
+#include "Log.h"
+#include "WireTraceClass.h"
+#include "DeviceClass.h"
+
+//! DeviceClass polling cycle replayed from a captured session: output switched between the cycle requests
+class DeviceTestClass : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+
+	void outputOff_data();
+	void outputOff();
+
+protected:
+	static constexpr int TIMEOUT = 5000; //!< ms
+
+	QTemporaryDir _dir;
+};
+
+void DeviceTestClass::initTestCase()
+{
+	Log::setLevel(Log::CategoryEnum::Serial, Log::LevelEnum::None);
+	QVERIFY(_dir.isValid());
+}
+
+void DeviceTestClass::outputOff_data()
+{
+	QTest::addColumn<bool>("requested");
+	QTest::addColumn<QString>("events");
+
+	// OUT0 requested by setOutput() isn't a trip
+	QTest::newRow("requested") << true << QString("output off");
+	QTest::newRow("not requested") << false << QString("output off; OCP trip");
+}
+
+void DeviceTestClass::outputOff()
+{
+	QFETCH(bool, requested);
+	QFETCH(QString, events);
+
+	// KA3005P in CC with OCP on: the output goes off between 2 status polls
+	typedef WireTraceClass::DirectionEnum D;
+	QVector<WireTraceClass::Record> records = {
+		{ 0, D::Open, "/dev/ttyACM0" },
+		{ 0, D::TX, "*IDN?" },
+		{ 0, D::RX, "KORAD KA3005P V5.8 SN:03379314" },
+		{ 0, D::TX, "VSET1?" },
+		{ 0, D::RX, "12.00" },
+		{ 0, D::TX, "ISET1?" },
+		{ 0, D::RX, "1.000" },
+		{ 0, D::TX, "VOUT1?" },
+		{ 0, D::RX, "12.00" },
+		{ 0, D::TX, "IOUT1?" },
+		{ 0, D::RX, "1.000" },
+		{ 0, D::TX, "STATUS?" },
+		{ 0, D::RX, "\x60" },
+		{ 0, D::TX, "VSET1?" },
+		{ 0, D::RX, "12.00" },
+	};
+	if(requested)
+		records.append({ 0, D::TX, "OUT0" });
+	records += {
+		{ 0, D::TX, "ISET1?" },
+		{ 0, D::RX, "1.000" },
+		{ 0, D::TX, "VOUT1?" },
+		{ 0, D::RX, "00.00" },
+		{ 0, D::TX, "IOUT1?" },
+		{ 0, D::RX, "0.000" },
+		{ 0, D::TX, "STATUS?" },
+		{ 0, D::RX, "\x20" },
+	};
+	auto fileName = _dir.filePath(QString("%0.wire").arg(QTest::currentDataTag()).replace(' ', '_'));
+	WireTraceClass trace;
+	QVERIFY(trace.openWrite(fileName));
+	foreach(const auto &record, records)
+		trace.write(record.direction, record.data);
+	trace.close();
+
+	DeviceClass device(0);
+	QSignalSpy statusEvents(&device, SIGNAL(statusEvent(StatusClass::Event)));
+	QSignalSpy closed(&device, SIGNAL(serialPortClosed(QString)));
+	// the output is switched off while the cycle request following the first status poll is pending
+	bool switched = false;
+	connect(&device, &ProtocolClass::answer, [&](ProtocolClass::RequestEnum r, QByteArray) {
+		if(requested && !switched && r == ProtocolClass::RequestEnum::STATUSQ)
+		{
+			switched = true;
+			device.setOutput(false);
+		}
+	});
+	QVERIFY(device.setReplay(fileName, false));
+
+	// the request following the trace closes the replay
+	QTRY_VERIFY_WITH_TIMEOUT(closed.count() > 0, TIMEOUT);
+	QStringList names;
+	foreach(const auto &args, statusEvents)
+		names.append(StatusClass::eventName(args[0].value<StatusClass::Event>().type));
+	QCOMPARE(names.join("; "), events);
+}
+
+QTEST_MAIN(DeviceTestClass)
+
+#include "tst_device.moc"
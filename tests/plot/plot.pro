@@ -0,0 +1,12 @@
+include(../tests.pri)
+
+QT += widgets printsupport concurrent
+
+TARGET = tst_plot
+
+SOURCES += \
+	tst_plot.cpp \
+	$$SRC/qcustomplot.cpp
+
+HEADERS += \
+	$$SRC/qcustomplot.h
@@ -0,0 +1,308 @@
+#include <math.h>
+#include <QtTest>
+#include "qcustomplot.h"
+
+//! QTEST_MAIN creates the application: select the offscreen platform before, unless the platform is given
+static const bool _offscreen = qEnvironmentVariableIsSet("QT_QPA_PLATFORM") || qputenv("QT_QPA_PLATFORM", "offscreen");
+
+//! Graph with the line data pipeline steps exposed to the benchmarks
+class GraphClass : public QCPGraph
+{
+public:
+	GraphClass(QCPAxis *keyAxis, QCPAxis *valueAxis) : QCPGraph(keyAxis, valueAxis) {}
+
+	using QCPGraph::getVisibleDataBounds;
+	using QCPGraph::getOptimizedLineData;
+	using QCPGraph::dataToLines;
+	using QCPGraph::getLines;
+	using QCPGraph::drawPolyline;
+};
+
+//! Rendering benchmarks of the shipped QCustomPlot
+//! Matrix: 1e3..1e7 points; pen widths; antialiasing on/off; line, step & scatter styles
+class PlotBenchmarkClass : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+	void cleanupTestCase();
+
+	void replot_data();
+	void replot();
+	void getOptimizedLineData_data();
+	void getOptimizedLineData();
+	void dataToLines_data();
+	void dataToLines();
+	void drawPolyline_data();
+	void drawPolyline();
+	void ticks_data();
+	void ticks();
+	void savePng_data();
+	void savePng();
+
+protected:
+	static constexpr int WIDTH = 1280; //!< Plot size, px
+	static constexpr int HEIGHT = 720;
+
+	QCustomPlot *_plot = nullptr;
+	GraphClass *_graph = nullptr;
+	QSharedPointer<QCPGraphDataContainer> _data; //!< Noisy sine of _points; shared by the rows of the same points count
+	int _points = 0;
+
+	//! Adds rows of points x widths x antialiasing x styles
+	//! @param points	Points counts of the rows: 0 terminated
+	//! @param pens	false - a row per points count: 1 px line without antialiasing
+	static void addMatrix(const int *points, bool pens);
+	//! Sets the graph data & style of the row
+	void setup(int points, int width, bool antialiased, const QString &style, bool adaptive = true);
+};
+
+static const int ALL_POINTS[] = { 1000, 10000, 100000, 1000000, 10000000, 0 };
+static const int PNG_POINTS[] = { 1000, 100000, 10000000, 0 };
+
+void PlotBenchmarkClass::initTestCase()
+{
+	_plot = new QCustomPlot;
+	_plot->resize(WIDTH, HEIGHT);
+	_plot->show();
+	QVERIFY(QTest::qWaitForWindowExposed(_plot));
+	_graph = new GraphClass(_plot->xAxis, _plot->yAxis);
+}
+
+void PlotBenchmarkClass::cleanupTestCase()
+{
+	delete _plot;
+}
+
+void PlotBenchmarkClass::addMatrix(const int *points, bool pens)
+{
+	QTest::addColumn<int>("points");
+	QTest::addColumn<int>("width");
+	QTest::addColumn<bool>("antialiased");
+	QTest::addColumn<QString>("style");
+	static const int WIDTHS[] = { 1, 2, 4 };
+	static const char *STYLES[] = { "line", "step", "scatter" };
+	for(; *points; points++)
+	{
+		if(!pens)
+		{
+			QTest::newRow(QString("%0").arg(*points).toLatin1()) << *points << 1 << false << QString("line");
+			continue;
+		}
+		for(auto width : WIDTHS)
+			for(auto antialiased : { false, true })
+				for(auto style : STYLES)
+					QTest::newRow(QString("%0 width %1 %2 %3").arg(*points).arg(width).arg(antialiased ? "aa" : "noaa")
+						.arg(style).toLatin1()) << *points << width << antialiased << QString(style);
+	}
+}
+
+void PlotBenchmarkClass::setup(int points, int width, bool antialiased, const QString &style, bool adaptive)
+{
+	if(points != _points)
+	{
+		// the previous data is released first: 1e7 points take 160 MB
+		_graph->setData(QSharedPointer<QCPGraphDataContainer>(new QCPGraphDataContainer));
+		_data.reset(new QCPGraphDataContainer);
+		QVector<QCPGraphData> data(points);
+		quint32 random = 1;
+		for(int i = 0; i < points; i++)
+		{
+			// deterministic noise: LCG
+			random = random * 1664525 + 1013904223;
+			data[i] = QCPGraphData(i, sin(i * 20. / points) + (random >> 8) / double(1 << 24) * 0.1);
+		}
+		_data->set(data, true);
+		_points = points;
+	}
+	_graph->setData(_data);
+	_graph->setAdaptiveSampling(adaptive);
+	_graph->setPen(QPen(Qt::blue, width));
+	_plot->setAntialiasedElements(antialiased ? QCP::aeAll : QCP::aeNone);
+	_plot->setNotAntialiasedElements(antialiased ? QCP::aeNone : QCP::aeAll);
+	if(style == "scatter")
+	{
+		_graph->setLineStyle(QCPGraph::lsNone);
+		_graph->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssDisc, 4));
+	}
+	else
+	{
+		_graph->setLineStyle(style == "step" ? QCPGraph::lsStepLeft : QCPGraph::lsLine);
+		_graph->setScatterStyle(QCPScatterStyle::ssNone);
+	}
+	_plot->xAxis->setRange(0, points);
+	_plot->yAxis->setRange(-1.5, 1.5);
+	// layout for the pipeline steps
+	_plot->replot();
+}
+
+void PlotBenchmarkClass::replot_data()
+{
+	addMatrix(ALL_POINTS, true);
+}
+
+void PlotBenchmarkClass::replot()
+{
+	QFETCH(int, points);
+	QFETCH(int, width);
+	QFETCH(bool, antialiased);
+	QFETCH(QString, style);
+	setup(points, width, antialiased, style);
+	QBENCHMARK
+	{
+		_plot->replot(QCustomPlot::rpImmediateRefresh);
+	}
+}
+
+void PlotBenchmarkClass::getOptimizedLineData_data()
+{
+	QTest::addColumn<int>("points");
+	QTest::addColumn<bool>("adaptive");
+	for(auto points = ALL_POINTS; *points; points++)
+		for(auto adaptive : { false, true })
+			QTest::newRow(QString("%0 %1").arg(*points).arg(adaptive ? "adaptive" : "all").toLatin1()) << *points << adaptive;
+}
+
+void PlotBenchmarkClass::getOptimizedLineData()
+{
+	QFETCH(int, points);
+	QFETCH(bool, adaptive);
+	setup(points, 1, false, "line", adaptive);
+	QCPGraphDataContainer::const_iterator begin, end;
+	_graph->getVisibleDataBounds(begin, end, QCPDataRange(0, _graph->dataCount()));
+	QVector<QCPGraphData> lineData;
+	QBENCHMARK
+	{
+		_graph->getOptimizedLineData(&lineData, begin, end);
+	}
+	QVERIFY(!lineData.isEmpty());
+}
+
+void PlotBenchmarkClass::dataToLines_data()
+{
+	addMatrix(ALL_POINTS, false);
+}
+
+void PlotBenchmarkClass::dataToLines()
+{
+	QFETCH(int, points);
+	// all points: conversion without adaptive sampling
+	setup(points, 1, false, "line", false);
+	QCPGraphDataContainer::const_iterator begin, end;
+	_graph->getVisibleDataBounds(begin, end, QCPDataRange(0, _graph->dataCount()));
+	QVector<QCPGraphData> lineData;
+	_graph->getOptimizedLineData(&lineData, begin, end);
+	QVector<QPointF> lines;
+	QBENCHMARK
+	{
+		lines = _graph->dataToLines(lineData);
+	}
+	QCOMPARE(lines.size(), lineData.size());
+}
+
+void PlotBenchmarkClass::drawPolyline_data()
+{
+	QTest::addColumn<int>("points");
+	QTest::addColumn<int>("width");
+	QTest::addColumn<bool>("antialiased");
+	QTest::addColumn<bool>("dashed");
+	static const int WIDTHS[] = { 1, 2, 4 };
+	for(auto points = ALL_POINTS; *points; points++)
+		for(auto width : WIDTHS)
+			for(auto antialiased : { false, true })
+				for(auto dashed : { false, true })
+					QTest::newRow(QString("%0 width %1 %2 %3").arg(*points).arg(width).arg(antialiased ? "aa" : "noaa")
+						.arg(dashed ? "dash" : "solid").toLatin1()) << *points << width << antialiased << dashed;
+}
+
+void PlotBenchmarkClass::drawPolyline()
+{
+	QFETCH(int, points);
+	QFETCH(int, width);
+	QFETCH(bool, antialiased);
+	QFETCH(bool, dashed);
+	setup(points, width, antialiased, "line");
+	QVector<QPointF> lines;
+	_graph->getLines(&lines, QCPDataRange(0, _graph->dataCount()));
+	QImage image(WIDTH, HEIGHT, QImage::Format_ARGB32_Premultiplied);
+	image.fill(Qt::white);
+	QCPPainter painter(&image);
+	painter.setAntialiasing(antialiased);
+	painter.setPen(QPen(QBrush(Qt::blue), width, dashed ? Qt::DashLine : Qt::SolidLine));
+	QBENCHMARK
+	{
+		_graph->drawPolyline(&painter, lines);
+	}
+}
+
+void PlotBenchmarkClass::ticks_data()
+{
+	QTest::addColumn<QString>("ticker");
+	QTest::addColumn<double>("span");
+	QTest::addColumn<bool>("scroll");
+	for(auto ticker : { "default", "fixed", "time" })
+		for(auto span : { 1., 60., 3600., 1e6 })
+			for(auto scroll : { false, true })
+				QTest::newRow(QString("%0 span %1 %2").arg(ticker).arg(span).arg(scroll ? "scroll" : "static").toLatin1())
+					<< QString(ticker) << span << scroll;
+}
+
+void PlotBenchmarkClass::ticks()
+{
+	QFETCH(QString, ticker);
+	QFETCH(double, span);
+	QFETCH(bool, scroll);
+	QSharedPointer<QCPAxisTicker> t;
+	if(ticker == "fixed")
+	{
+		auto fixed = new QCPAxisTickerFixed;
+		fixed->setTickStep(span / 6);
+		t.reset(fixed);
+	}
+	else if(ticker == "time")
+		t.reset(new QCPAxisTickerTime);
+	else
+		t.reset(new QCPAxisTicker);
+	QVector<double> ticks, subTicks;
+	QVector<QString> labels;
+	QLocale locale;
+	double lower = 0;
+	QBENCHMARK
+	{
+		t->generate(QCPRange(lower, lower + span), locale, 'g', 6, ticks, &subTicks, &labels);
+		// a scrolling graph shifts the range by sample
+		if(scroll)
+			lower += span / 100;
+	}
+	QCOMPARE(labels.size(), ticks.size());
+}
+
+void PlotBenchmarkClass::savePng_data()
+{
+	QTest::addColumn<int>("points");
+	QTest::addColumn<bool>("antialiased");
+	for(auto points = PNG_POINTS; *points; points++)
+		for(auto antialiased : { false, true })
+			QTest::newRow(QString("%0 %1").arg(*points).arg(antialiased ? "aa" : "noaa").toLatin1())
+				<< *points << antialiased;
+}
+
+void PlotBenchmarkClass::savePng()
+{
+	QFETCH(int, points);
+	QFETCH(bool, antialiased);
+	setup(points, 2, antialiased, "line");
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	bool ok = true;
+	QBENCHMARK
+	{
+		ok &= _plot->savePng(dir.filePath("plot.png"));
+	}
+	QVERIFY(ok);
+}
+
+QTEST_MAIN(PlotBenchmarkClass)
+
+#include "tst_plot.moc"
@@ -0,0 +1,12 @@
+include(../tests.pri)
+
+QT += serialport network concurrent
+
+TARGET = tst_replay
+
+SOURCES += \
+	tst_replay.cpp \
+	$$PROTOCOL_SOURCES
+
+HEADERS += \
+	$$PROTOCOL_HEADERS
@@ -0,0 +1,96 @@
+#include <QtTest>
+#include "Log.h"
+#include "WireTraceClass.h"
+#include "ProtocolClass.h"
+
+Q_DECLARE_METATYPE(QVector<WireTraceClass::Record>)
+
+//! Replay of captured sessions: PSU identified by IDN request or by the port discovery probe
+class ReplayClass : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+
+	void identify_data();
+	void identify();
+
+protected:
+	static constexpr int TIMEOUT = 5000; //!< ms
+	static constexpr const char *IDN = "KORAD KA3005P V5.8 SN:03379314";
+
+	QTemporaryDir _dir;
+};
+
+void ReplayClass::initTestCase()
+{
+	Log::setLevel(Log::CategoryEnum::Serial, Log::LevelEnum::None);
+	QVERIFY(_dir.isValid());
+}
+
+void ReplayClass::identify_data()
+{
+	typedef WireTraceClass::DirectionEnum D;
+	typedef QVector<WireTraceClass::Record> Records;
+	QTest::addColumn<Records>("records");
+
+	// session of the opened port follows the probe records
+	Records session = {
+		{ 0, D::Open, "/dev/ttyACM0" },
+		{ 0, D::TX, "VOUT1?" },
+		{ 0, D::RX, "12.34" },
+	};
+	QTest::newRow("IDN request") << (Records {
+		{ 0, D::Open, "/dev/ttyACM0" },
+		{ 0, D::TX, "*IDN?" },
+		{ 0, D::RX, IDN },
+		{ 0, D::TX, "VOUT1?" },
+		{ 0, D::RX, "12.34" },
+	});
+	QTest::newRow("probe") << (Records {
+		{ 0, D::Probe, "/dev/ttyACM0" },
+		{ 0, D::ProbeTX, "*IDN?" },
+		{ 0, D::ProbeRX, "KORAD KA3005P" },
+		{ 0, D::ProbeRX, " V5.8 SN:03379314" },
+	} + session);
+	QTest::newRow("probe candidates") << (Records {
+		{ 0, D::Probe, "/dev/ttyUSB0" },
+		{ 0, D::ProbeTX, "*IDN?" },
+		{ 0, D::ProbeRX, "?" },
+		{ 0, D::Probe, "/dev/ttyACM0" },
+		{ 0, D::ProbeTX, "*IDN?" },
+		{ 0, D::ProbeRX, IDN },
+	} + session);
+}
+
+void ReplayClass::identify()
+{
+	QFETCH(QVector<WireTraceClass::Record>, records);
+	auto fileName = _dir.filePath(QString("%0.wire").arg(QTest::currentDataTag()).replace(' ', '_'));
+	WireTraceClass trace;
+	QVERIFY(trace.openWrite(fileName));
+	foreach(const auto &record, records)
+		trace.write(record.direction, record.data);
+	trace.close();
+
+	ProtocolClass protocol;
+	QSignalSpy models(&protocol, SIGNAL(modelDetected(QString)));
+	QSignalSpy values(&protocol, SIGNAL(answerValue(ProtocolClass::RequestEnum,float)));
+	QSignalSpy closed(&protocol, SIGNAL(serialPortClosed(QString)));
+	QVERIFY(protocol.setReplay(fileName, false));
+
+	QTRY_COMPARE_WITH_TIMEOUT(models.count(), 1, TIMEOUT);
+	QCOMPARE(models[0][0].toString(), QString(IDN));
+	QVERIFY(protocol.model());
+
+	// the polling request is answered by the session records: not taken as IDN answer
+	protocol.request(ProtocolClass::RequestEnum::VOUT1Q);
+	QTRY_COMPARE_WITH_TIMEOUT(values.count(), 1, TIMEOUT);
+	QCOMPARE(values[0][1].toFloat(), 12.34f);
+	QCOMPARE(closed.count(), 0);
+}
+
+QTEST_MAIN(ReplayClass)
+
+#include "tst_replay.moc"
@@ -0,0 +1,12 @@
+include(../tests.pri)
+
+QT += serialport network concurrent
+
+TARGET = tst_rxalloc
+
+SOURCES += \
+	tst_rxalloc.cpp \
+	$$PROTOCOL_SOURCES
+
+HEADERS += \
+	$$PROTOCOL_HEADERS
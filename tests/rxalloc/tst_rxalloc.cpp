@@ -0,0 +1,152 @@
+#include <stdlib.h>
+#include <QtTest>
+#include "WireTraceClass.h"
+#include "ProtocolClass.h"
+
+//! Heap allocations of this thread: malloc family hooks; operator new allocates by malloc
+static thread_local quint64 _allocations = 0;
+
+#ifdef __GLIBC__
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *pointer, size_t size);
+
+extern "C" void *malloc(size_t size)
+{
+	_allocations++;
+	return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+	_allocations++;
+	return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *pointer, size_t size)
+{
+	_allocations++;
+	return __libc_realloc(pointer, size);
+}
+#endif
+
+//! Polls VOUT1? & IOUT1? alternately from the replayed trace; counts allocations of the receive path:
+//! dataArrived(), answer parsing & answerValue() emission, without sending of the next request
+class ReplayProtocolClass : public ProtocolClass
+{
+	Q_OBJECT
+
+public:
+	static constexpr int WARMUP_SAMPLES = 100; //!< Lazily allocated buffers settle
+
+	ReplayProtocolClass()
+	{
+		connect(this, SIGNAL(modelDetected(QString)), SLOT(_modelDetected()));
+		connect(this, SIGNAL(answerValue(ProtocolClass::RequestEnum,float)),
+			SLOT(_answerValue(ProtocolClass::RequestEnum,float)));
+	}
+
+	int samples = 0; //!< Answered values count
+	int parsed = 0; //!< Answered values parsed count
+	bool complete = false; //!< Trace is over
+	quint64 rxAllocations = 0; //!< Receive path allocations of the samples after the warm up
+	quint64 allocations = 0; //!< All allocations of the samples after the warm up: replay & send included
+
+protected slots:
+	void _modelDetected()
+	{
+		request(RequestEnum::VOUT1Q);
+	}
+
+	void _answerValue(ProtocolClass::RequestEnum r, float value)
+	{
+		samples++;
+		if(!qIsNaN(value))
+			parsed++;
+		if(samples == WARMUP_SAMPLES)
+			_warmupAllocations = _allocations;
+		auto before = _allocations;
+		request(r == RequestEnum::VOUT1Q ? RequestEnum::IOUT1Q : RequestEnum::VOUT1Q);
+		_sendAllocations += _allocations - before;
+	}
+
+protected:
+	quint64 _sendAllocations = 0; //!< Allocations of the requests sent by the current dataArrived()
+	quint64 _warmupAllocations = 0;
+
+	void dataArrived(const char *data, int length) override
+	{
+		auto counted = samples >= WARMUP_SAMPLES;
+		auto before = _allocations;
+		_sendAllocations = 0;
+		ProtocolClass::dataArrived(data, length);
+		if(counted)
+			rxAllocations += _allocations - before - _sendAllocations;
+	}
+
+	void portClosed() override
+	{
+		ProtocolClass::portClosed();
+		if(samples >= WARMUP_SAMPLES)
+			allocations = _allocations - _warmupAllocations;
+		complete = true;
+	}
+};
+
+//! Receive path of --replay-fast over a generated trace must not allocate per sample
+class RxAllocClass : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+	void replay();
+
+protected:
+	static constexpr int SAMPLES = 10000;
+
+	QTemporaryDir _dir;
+	QString _traceName;
+};
+
+void RxAllocClass::initTestCase()
+{
+#ifndef __GLIBC__
+	QSKIP("malloc hooks need glibc");
+#endif
+	QVERIFY(_dir.isValid());
+	_traceName = _dir.filePath("replay.wire");
+	WireTraceClass trace;
+	QVERIFY(trace.openWrite(_traceName));
+	trace.write(WireTraceClass::DirectionEnum::Open, QByteArray("/dev/ttyACM0"));
+	trace.write(WireTraceClass::DirectionEnum::TX, QByteArray("*IDN?"));
+	trace.write(WireTraceClass::DirectionEnum::RX, QByteArray("KORAD KA3005P V5.8 SN:03379314"));
+	for(int i = 0; i < SAMPLES / 2; i++)
+	{
+		// answers arrive in chunks: accumulated in the answer buffer
+		trace.write(WireTraceClass::DirectionEnum::TX, QByteArray("VOUT1?"));
+		trace.write(WireTraceClass::DirectionEnum::RX, QByteArray("12."));
+		trace.write(WireTraceClass::DirectionEnum::RX, QByteArray::number(i % 100).rightJustified(2, '0'));
+		trace.write(WireTraceClass::DirectionEnum::TX, QByteArray("IOUT1?"));
+		trace.write(WireTraceClass::DirectionEnum::RX, QByteArray("0.500"));
+	}
+	trace.close();
+}
+
+void RxAllocClass::replay()
+{
+	ReplayProtocolClass protocol;
+	QVERIFY(protocol.setReplay(_traceName, false));
+	QTRY_VERIFY_WITH_TIMEOUT(protocol.complete, 60000);
+
+	QCOMPARE(protocol.samples, SAMPLES);
+	QCOMPARE(protocol.parsed, SAMPLES);
+	auto counted = SAMPLES - ReplayProtocolClass::WARMUP_SAMPLES;
+	qInfo("%d samples: receive path %.3f, whole loop %.3f allocations per sample", counted,
+		(double)protocol.rxAllocations / counted, (double)protocol.allocations / counted);
+	QCOMPARE(protocol.rxAllocations, 0ULL);
+}
+
+QTEST_MAIN(RxAllocClass)
+
+#include "tst_rxalloc.moc"
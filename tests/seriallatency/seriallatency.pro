@@ -0,0 +1,16 @@
+include(../tests.pri)
+
+QT += serialport network concurrent
+
+TARGET = tst_seriallatency
+
+LIBS += $$PTY_LIBS
+
+SOURCES += \
+	tst_seriallatency.cpp \
+	$$SRC/StatisticsClass.cpp \
+	$$SERIAL_SOURCES
+
+HEADERS += \
+	$$SRC/StatisticsClass.h \
+	$$SERIAL_HEADERS
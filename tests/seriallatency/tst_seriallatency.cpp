@@ -0,0 +1,158 @@
+#include <pty.h>
+#include <poll.h>
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+#include <QtTest>
+#include "Log.h"
+#include "StatisticsClass.h"
+#include "TransportClass.h"
+
+//! Round trip latency of the serial backends against a pty echo: QSerialPort vs native termios
+//! Round trips count per backend: LATENCY_ROUND_TRIPS environment variable
+class SerialLatencyClass : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+	void cleanupTestCase();
+
+	void roundTrip_data();
+	void roundTrip();
+
+protected:
+	static constexpr int DEFAULT_ROUND_TRIPS = 2000;
+	static constexpr int WARMUP_ROUND_TRIPS = 20;
+	static constexpr int ANSWER_TIMEOUT = 1000; //!< ms
+
+	int _master = -1; //!< pty master: echoed by the echo thread
+	QString _slaveName;
+	std::thread _echo;
+	std::atomic<bool> _stop { false };
+	int _roundTrips = DEFAULT_ROUND_TRIPS;
+	QStringList _results; //!< Summary line per backend
+
+	//! Echoes the bytes written to the slave back: runs in _echo
+	void echo();
+	//! Writes request & waits for the whole echo
+	//! @return Round trip, ns; -1 - timeout
+	static qint64 roundTrip(TransportClass *transport, const QByteArray &request);
+};
+
+void SerialLatencyClass::initTestCase()
+{
+	Log::setLevel(Log::CategoryEnum::Serial, Log::LevelEnum::None);
+
+	int slave;
+	char name[256];
+	QVERIFY(openpty(&_master, &slave, name, nullptr, nullptr) == 0);
+	::close(slave);
+	_slaveName = name;
+
+	bool ok;
+	auto roundTrips = qEnvironmentVariableIntValue("LATENCY_ROUND_TRIPS", &ok);
+	if(ok && roundTrips > 0)
+		_roundTrips = roundTrips;
+
+	_echo = std::thread(&SerialLatencyClass::echo, this);
+}
+
+void SerialLatencyClass::cleanupTestCase()
+{
+	_stop = true;
+	if(_echo.joinable())
+		_echo.join();
+	if(_master >= 0)
+		::close(_master);
+	foreach(auto line, _results)
+		qInfo().noquote() << line;
+}
+
+void SerialLatencyClass::echo()
+{
+	char buffer[256];
+	while(!_stop)
+	{
+		pollfd fd = { _master, POLLIN, 0 };
+		if(::poll(&fd, 1, 100) <= 0)
+			continue;
+		auto length = ::read(_master, buffer, sizeof(buffer));
+		if(length <= 0)
+		{
+			// EIO while the slave is closed between the backends
+			::usleep(1000);
+			continue;
+		}
+		for(ssize_t pos = 0; pos < length; )
+		{
+			auto written = ::write(_master, buffer + pos, length - pos);
+			if(written <= 0)
+				break;
+			pos += written;
+		}
+	}
+}
+
+void SerialLatencyClass::roundTrip_data()
+{
+	QTest::addColumn<bool>("native");
+	QTest::newRow("qt") << false;
+	QTest::newRow("native") << true;
+}
+
+void SerialLatencyClass::roundTrip()
+{
+	QFETCH(bool, native);
+	auto transport = TransportClass::create(native ? TransportClass::TypeEnum::NativeSerial
+		: TransportClass::TypeEnum::Serial, this);
+	QVERIFY2(transport->open(_slaveName), qPrintable(transport->errorString()));
+
+	// typical request & answer length
+	QByteArray request("VOUT1?");
+	for(int i = 0; i < WARMUP_ROUND_TRIPS; i++)
+		QVERIFY(roundTrip(transport, request) >= 0);
+
+	HistogramClass latency;
+	for(int i = 0; i < _roundTrips; i++)
+	{
+		auto ns = roundTrip(transport, request);
+		QVERIFY2(ns >= 0, qPrintable(QString("round trip %0 timeout").arg(i)));
+		latency.record(ns / 1000);
+	}
+	transport->close();
+	delete transport;
+
+	_results.append(QString("%0: %1 round trips, us: p50 %2 p99 %3 max %4")
+		.arg(QTest::currentDataTag(), -6).arg(latency.count())
+		.arg(latency.quantile(0.5)).arg(latency.quantile(0.99)).arg(latency.max()));
+}
+
+qint64 SerialLatencyClass::roundTrip(TransportClass *transport, const QByteArray &request)
+{
+	QEventLoop loop;
+	int received = 0;
+	char buffer[64];
+	auto connection = connect(transport, &TransportClass::readyRead, [&] {
+		qint64 length;
+		while((length = transport->read(buffer, sizeof(buffer))) > 0)
+			received += length;
+		if(received >= request.length() || length < 0)
+			loop.quit();
+	});
+	QTimer::singleShot(ANSWER_TIMEOUT, &loop, &QEventLoop::quit);
+
+	QElapsedTimer timer;
+	timer.start();
+	transport->write(request);
+	transport->flush();
+	loop.exec();
+	auto elapsed = timer.nsecsElapsed();
+
+	disconnect(connection);
+	return received >= request.length() ? elapsed : -1;
+}
+
+QTEST_MAIN(SerialLatencyClass)
+
+#include "tst_seriallatency.moc"
@@ -0,0 +1,14 @@
+include(../tests.pri)
+
+QT += serialport network concurrent
+
+TARGET = tst_soak
+
+LIBS += $$PTY_LIBS
+
+SOURCES += \
+	tst_soak.cpp \
+	$$SERIAL_SOURCES
+
+HEADERS += \
+	$$SERIAL_HEADERS
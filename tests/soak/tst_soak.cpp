@@ -0,0 +1,138 @@
+#include <pty.h>
+#include <unistd.h>
+#include <QtTest>
+#include "Log.h"
+#include "SerialPortClass.h"
+
+//! Serial port without protocol: counts opens
+class PortClass : public SerialPortClass
+{
+public:
+	PortClass() : SerialPortClass(QVector<VidPid>())
+	{
+		// the cycles open the port by reconnects only
+		stopReconnectTimer();
+	}
+
+	int opened = 0; //!< portOpened() calls count
+
+protected:
+	void portOpened() override { opened++; }
+	void portClosed() override {}
+	void dataArrived(const char *data, int length) override { Q_UNUSED(data) Q_UNUSED(length) }
+};
+
+//! Reconnect loop soak test against an emulated pty: RSS & QObject children must stay flat
+//! Cycles count: SOAK_CYCLES environment variable
+class SoakClass : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+	void cleanupTestCase();
+
+	void reconnect_data();
+	void reconnect();
+
+protected:
+	static constexpr int DEFAULT_CYCLES = 2000;
+	static constexpr int WARMUP_CYCLES = 50; //!< Lazily created objects & allocator pools settle
+	static constexpr int OPEN_TIMEOUT = 2000; //!< Reconnect timeout, ms
+	static constexpr qint64 RSS_TOLERANCE = 512 * 1024; //!< Allocator noise, bytes
+	static constexpr const char *MISSING_PORT = "/dev/korad-psu-soak-missing";
+
+	int _master = -1; //!< pty master: keeps the slave openable
+	QString _slaveName;
+	int _cycles = DEFAULT_CYCLES;
+
+	//! Fails to open a missing port, then closes & reopens the pty by the reconnect timer
+	//! @return false on unexpected open result or reconnect timeout
+	bool cycle(PortClass &port);
+	//! @return Resident set size, bytes
+	static qint64 residentSize();
+};
+
+void SoakClass::initTestCase()
+{
+	// every cycle logs open, close & error
+	Log::setLevel(Log::CategoryEnum::Serial, Log::LevelEnum::None);
+
+	int slave;
+	char name[256];
+	QVERIFY(openpty(&_master, &slave, name, nullptr, nullptr) == 0);
+	// the port reopens the slave by name
+	::close(slave);
+	_slaveName = name;
+
+	bool ok;
+	auto cycles = qEnvironmentVariableIntValue("SOAK_CYCLES", &ok);
+	if(ok && cycles > 0)
+		_cycles = cycles;
+}
+
+void SoakClass::cleanupTestCase()
+{
+	if(_master >= 0)
+		::close(_master);
+}
+
+void SoakClass::reconnect_data()
+{
+	QTest::addColumn<bool>("native");
+	QTest::newRow("qt") << false;
+	QTest::newRow("native") << true;
+}
+
+void SoakClass::reconnect()
+{
+	QFETCH(bool, native);
+	PortClass port;
+	port.setNativeBackend(native);
+	port.setPortName(_slaveName);
+
+	for(int i = 0; i < WARMUP_CYCLES; i++)
+		QVERIFY2(cycle(port), qPrintable(QString("warm up cycle %0").arg(i)));
+	auto children = port.findChildren<QObject*>().size();
+	auto rss = residentSize();
+
+	for(int i = 0; i < _cycles; i++)
+		QVERIFY2(cycle(port), qPrintable(QString("cycle %0").arg(i)));
+
+	QCOMPARE(port.findChildren<QObject*>().size(), children);
+	auto growth = residentSize() - rss;
+	QVERIFY2(growth <= RSS_TOLERANCE, qPrintable(QString("RSS grew by %0 KB over %1 cycles")
+		.arg(growth / 1024).arg(_cycles)));
+}
+
+bool SoakClass::cycle(PortClass &port)
+{
+	if(port.openSerialPort(SerialPortClass::PortAndVidPid(MISSING_PORT, MISSING_PORT)))
+		return false;
+
+	auto opened = port.opened;
+	port.closeSerialPortAndReconnect();
+	QElapsedTimer timer;
+	timer.start();
+	while(port.opened == opened)
+	{
+		if(timer.elapsed() > OPEN_TIMEOUT)
+			return false;
+		QCoreApplication::processEvents();
+	}
+	return true;
+}
+
+qint64 SoakClass::residentSize()
+{
+	QFile file("/proc/self/statm");
+	if(!file.open(QIODevice::ReadOnly))
+		return 0;
+	// size resident shared text lib data dt: pages
+	auto fields = file.readAll().split(' ');
+	return fields.size() > 1 ? fields[1].toLongLong() * sysconf(_SC_PAGESIZE) : 0;
+}
+
+QTEST_MAIN(SoakClass)
+
+#include "tst_soak.moc"
@@ -0,0 +1,10 @@
+include(../tests.pri)
+
+TARGET = tst_status
+
+SOURCES += \
+	tst_status.cpp \
+	$$SRC/StatusClass.cpp
+
+HEADERS += \
+	$$SRC/StatusClass.h
@@ -0,0 +1,86 @@
+#include <QtTest>
+#include "StatusClass.h"
+
+//! STATUS? bits of the edge cases
+static constexpr int CV1 = 1 << 0;
+static constexpr int CV2 = 1 << 1;
+static constexpr int OCP = 1 << 5;
+static constexpr int OUT = 1 << 6;
+static constexpr int OVP = 1 << 7;
+
+//! StatusClass::edges: mode, output & trip edges between 2 status polls
+class StatusTestClass : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void edges_data();
+	void edges();
+	void timing();
+
+protected:
+	//! @return Example: "output off CH1; OCP trip CH1"
+	static QString toText(const QVector<StatusClass::Event> &events);
+};
+
+QString StatusTestClass::toText(const QVector<StatusClass::Event> &events)
+{
+	QStringList ret;
+	foreach(auto &event, events)
+		ret.append(QString("%0 CH%1").arg(StatusClass::eventName(event.type)).arg(event.channel + 1));
+	return ret.join("; ");
+}
+
+void StatusTestClass::edges_data()
+{
+	QTest::addColumn<int>("previous");
+	QTest::addColumn<int>("current");
+	QTest::addColumn<int>("channels");
+	QTest::addColumn<bool>("outputOffRequested");
+	QTest::addColumn<QString>("events");
+
+	QTest::newRow("unchanged") << (OUT | CV1) << (OUT | CV1) << 1 << false << QString();
+	QTest::newRow("CC entered") << (OUT | CV1) << OUT << 1 << false << QString("CC entered CH1");
+	QTest::newRow("CV entered") << OUT << (OUT | CV1) << 1 << false << QString("CV entered CH1");
+	QTest::newRow("CH2 of single channel") << (OUT | CV1) << (OUT | CV1 | CV2) << 1 << false << QString();
+	QTest::newRow("CH2 CV entered") << (OUT | CV1) << (OUT | CV1 | CV2) << 2 << false << QString("CV entered CH2");
+	QTest::newRow("output on") << CV1 << (OUT | CV1) << 1 << false << QString("output on CH1");
+	QTest::newRow("output off") << (OUT | CV1) << CV1 << 1 << false << QString("output off CH1");
+	QTest::newRow("OCP trip") << (OUT | OCP) << OCP << 1 << false << QString("output off CH1; OCP trip CH1");
+	QTest::newRow("OCP requested off") << (OUT | OCP) << OCP << 1 << true << QString("output off CH1");
+	QTest::newRow("OVP trip") << (OUT | OVP | CV1) << (OVP | CV1) << 1 << false << QString("output off CH1; OVP trip CH1");
+	QTest::newRow("OVP requested off") << (OUT | OVP | CV1) << (OVP | CV1) << 1 << true << QString("output off CH1");
+	QTest::newRow("OVP in CC") << (OUT | OVP) << OVP << 1 << false << QString("output off CH1");
+	QTest::newRow("OCP in CV") << (OUT | OCP | CV1) << (OCP | CV1) << 1 << false << QString("output off CH1");
+	QTest::newRow("CC trip to CV") << (OUT | OCP) << (OCP | CV1) << 1 << false
+		<< QString("CV entered CH1; output off CH1; OCP trip CH1");
+}
+
+void StatusTestClass::edges()
+{
+	QFETCH(int, previous);
+	QFETCH(int, current);
+	QFETCH(int, channels);
+	QFETCH(bool, outputOffRequested);
+	QFETCH(QString, events);
+
+	QVector<StatusClass::Event> ret;
+	StatusClass((quint8)current).edges(StatusClass((quint8)previous), channels, outputOffRequested, 0, 0, &ret);
+	QCOMPARE(toText(ret), events);
+}
+
+void StatusTestClass::timing()
+{
+	QVector<StatusClass::Event> events;
+	StatusClass(CV1).edges(StatusClass(OUT), 1, false, 5000, 2000, &events);
+	QCOMPARE(events.size(), 2);
+	foreach(auto &event, events)
+	{
+		QCOMPARE(event.timestamp, 5000ULL);
+		QCOMPARE(event.window, 2000ULL);
+	}
+}
+
+QTEST_MAIN(StatusTestClass)
+
+#include "tst_status.moc"
@@ -0,0 +1,12 @@
+include(../tests.pri)
+
+QT += serialport network concurrent
+
+TARGET = tst_tcptransport
+
+SOURCES += \
+	tst_tcptransport.cpp \
+	$$PROTOCOL_SOURCES
+
+HEADERS += \
+	$$PROTOCOL_HEADERS
@@ -0,0 +1,175 @@
+#include <QtTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include "TcpTransportClass.h"
+#include "ProtocolClass.h"
+
+//! PSU LAN port emulator: answers *IDN? & VOUT1? of the connected clients
+class EmulatorClass : public QTcpServer
+{
+	Q_OBJECT
+
+public:
+	static constexpr const char *IDN = "KORAD KA3005P V5.8 SN:03379314";
+	static constexpr const char *VOUT1 = "12.34";
+
+	explicit EmulatorClass(QObject *parent=NULL) : QTcpServer(parent)
+	{
+		connect(this, SIGNAL(newConnection()), SLOT(_newConnection()));
+	}
+
+	//! Answers requests automatically; false - the test reads the requests from the socket
+	bool answering = true;
+	QTcpSocket *socket = nullptr; //!< The last accepted connection
+
+protected slots:
+	void _newConnection()
+	{
+		while(hasPendingConnections())
+		{
+			socket = nextPendingConnection();
+			connect(socket, SIGNAL(readyRead()), SLOT(_socket_readyRead()));
+		}
+	}
+
+	void _socket_readyRead()
+	{
+		if(!answering)
+			return;
+		auto client = qobject_cast<QTcpSocket*>(sender());
+		_requests += client->readAll();
+		// requests have no terminator
+		for(;;)
+		{
+			if(_requests.startsWith("*IDN?"))
+			{
+				_requests.remove(0, 5);
+				client->write(IDN);
+			}
+			else if(_requests.startsWith("VOUT1?"))
+			{
+				_requests.remove(0, 6);
+				client->write(VOUT1);
+			}
+			else
+				break;
+		}
+	}
+
+protected:
+	QByteArray _requests; //!< Not answered bytes
+};
+
+//! TCP transport against a QTcpServer PSU emulator
+class TcpTransportTestClass : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+
+	void connectAsync();
+	void writeAtOnce();
+	void batchBackToBack();
+	void protocol();
+
+protected:
+	static constexpr int TIMEOUT = 5000; //!< ms
+
+	EmulatorClass _emulator;
+
+	QString portName() const
+	{
+		return QString("tcp://127.0.0.1:%0").arg(_emulator.serverPort());
+	}
+	//! Opens the transport to the emulator without answering
+	bool connectTransport(TcpTransportClass *transport);
+};
+
+void TcpTransportTestClass::initTestCase()
+{
+	QVERIFY(_emulator.listen(QHostAddress::LocalHost));
+}
+
+bool TcpTransportTestClass::connectTransport(TcpTransportClass *transport)
+{
+	_emulator.answering = false;
+	_emulator.socket = nullptr;
+	QSignalSpy opened(transport, SIGNAL(opened()));
+	if(!transport->open(portName()))
+		return false;
+	// the connection is established by the event loop
+	return QTest::qWaitFor([&] { return _emulator.socket != nullptr && opened.count() == 1; }, TIMEOUT)
+		&& transport->isOpen();
+}
+
+void TcpTransportTestClass::connectAsync()
+{
+	// nothing listens on the port: the refused connection fails by errorOccurred()
+	QTcpServer closed;
+	QVERIFY(closed.listen(QHostAddress::LocalHost));
+	auto port = closed.serverPort();
+	closed.close();
+
+	TcpTransportClass transport;
+	QSignalSpy opened(&transport, SIGNAL(opened()));
+	QSignalSpy errors(&transport, SIGNAL(errorOccurred(QString)));
+	QVERIFY(transport.open(QString("tcp://127.0.0.1:%0").arg(port)));
+	QVERIFY(!transport.isOpen());
+	QTRY_COMPARE_WITH_TIMEOUT(errors.count(), 1, TIMEOUT);
+	QCOMPARE(opened.count(), 0);
+	QVERIFY(!transport.errorString().isEmpty());
+}
+
+void TcpTransportTestClass::writeAtOnce()
+{
+	TcpTransportClass transport;
+	QVERIFY(connectTransport(&transport));
+	auto socket = _emulator.socket;
+
+	// the transport event loop doesn't run: the request is sent by write() itself
+	transport.write("VOUT1?");
+	QVERIFY(socket->waitForReadyRead(TIMEOUT));
+	QCOMPARE(socket->readAll(), QByteArray("VOUT1?"));
+}
+
+void TcpTransportTestClass::batchBackToBack()
+{
+	TcpTransportClass transport;
+	QVERIFY(connectTransport(&transport));
+	auto socket = _emulator.socket;
+
+	transport.write("VSET1:12.00");
+	transport.write("ISET1:1.000");
+	transport.write("OUT1");
+	QVERIFY(socket->waitForReadyRead(TIMEOUT));
+	QCOMPARE(socket->readAll(), QByteArray("VSET1:12.00"));
+
+	// the writes following the first one are sent together on the next event loop pass
+	QByteArray batch;
+	QTRY_VERIFY_WITH_TIMEOUT((batch += socket->readAll()).size() >= 15, TIMEOUT);
+	QCOMPARE(batch, QByteArray("ISET1:1.000OUT1"));
+}
+
+void TcpTransportTestClass::protocol()
+{
+	_emulator.answering = true;
+	ProtocolClass protocol;
+	protocol.setPortName(portName());
+	QSignalSpy models(&protocol, SIGNAL(modelDetected(QString)));
+	QSignalSpy values(&protocol, SIGNAL(answerValue(ProtocolClass::RequestEnum,float)));
+
+	QTRY_COMPARE_WITH_TIMEOUT(models.count(), 1, TIMEOUT);
+	QCOMPARE(models[0][0].toString(), QString(EmulatorClass::IDN));
+	QVERIFY(protocol.model());
+	QCOMPARE(protocol.model()->name, "KA3005P");
+
+	protocol.request(ProtocolClass::RequestEnum::VOUT1Q);
+	QTRY_COMPARE_WITH_TIMEOUT(values.count(), 1, TIMEOUT);
+	QCOMPARE(values[0][0].value<ProtocolClass::RequestEnum>(), ProtocolClass::RequestEnum::VOUT1Q);
+	QCOMPARE(values[0][1].toFloat(), 12.34f);
+}
+
+QTEST_MAIN(TcpTransportTestClass)
+
+#include "tst_tcptransport.moc"
@@ -0,0 +1,51 @@
+# Common settings of the test targets: the application sources are built from src/
+
+QT += testlib
+QT -= gui
+
+CONFIG += testcase c++17 console
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+SRC = $$PWD/../src
+INCLUDEPATH += $$SRC
+
+# Serial port stack: SerialPortClass with the transports
+SERIAL_SOURCES = \
+	$$SRC/SerialPortClass.cpp \
+	$$SRC/Log.cpp \
+	$$SRC/Trace.cpp \
+	$$SRC/WireTraceClass.cpp \
+	$$SRC/HotplugClass.cpp \
+	$$SRC/TransportClass.cpp \
+	$$SRC/SerialTransportClass.cpp \
+	$$SRC/NativeSerialPortClass.cpp \
+	$$SRC/TcpTransportClass.cpp
+
+SERIAL_HEADERS = \
+	$$SRC/SerialPortClass.h \
+	$$SRC/Log.h \
+	$$SRC/Trace.h \
+	$$SRC/WireTraceClass.h \
+	$$SRC/HotplugClass.h \
+	$$SRC/TransportClass.h \
+	$$SRC/SerialTransportClass.h \
+	$$SRC/NativeSerialPortClass.h \
+	$$SRC/TcpTransportClass.h
+
+# Protocol stack: ProtocolClass on the serial port stack
+PROTOCOL_SOURCES = \
+	$$SERIAL_SOURCES \
+	$$SRC/ProtocolClass.cpp \
+	$$SRC/ModelClass.cpp \
+	$$SRC/StatisticsClass.cpp
+
+PROTOCOL_HEADERS = \
+	$$SERIAL_HEADERS \
+	$$SRC/ProtocolClass.h \
+	$$SRC/ModelClass.h \
+	$$SRC/StatisticsClass.h
+
+# openpty()
+unix:!macx: PTY_LIBS = -lutil
@@ -0,0 +1,14 @@
+# Tests & benchmarks: qmake tests/tests.pro && make check
+# Benchmarks run on the offscreen platform; pass QtTest options by TESTARGS, example: make check TESTARGS="-iterations 10"
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+	plot \
+	soak \
+	seriallatency \
+	rxalloc \
+	tcptransport \
+	status \
+	replay \
+	device